@@ -0,0 +1,116 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "World.h"
+
+// 内存映射组件存储的吞吐量检查
+// 组件总量为内存预算的数倍，组件以 COLD 方式驻留
+// 每处理一批实体后调用 TrimColdComps 换出内存
+// 检查进程的常驻内存峰值不超过预算，并输出读写吞吐量
+
+// 每个组件 128 KB
+struct Chunk
+{
+	float values[32768];
+};
+
+// 实体数量，受 MAX_ENTITY_NUM 限制
+const std::size_t ENTITY_NUM = 960;
+// 每处理多少个实体换出一次内存
+const std::size_t TRIM_INTERVAL = 64;
+// 常驻内存的预算
+const std::size_t MEMORY_BUDGET = 48u << 20;
+// 遍历所有组件的次数
+const int PASS_NUM = 3;
+
+// 读取 /proc/self/status 中的内存信息，单位为字节，不支持的平台返回 0
+std::size_t ReadProcStatus(const char* key)
+{
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.compare(0, std::strlen(key), key) == 0)
+		{
+			return std::stoul(line.substr(std::strlen(key) + 1)) * 1024;
+		}
+	}
+
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	std::size_t base_rss = ReadProcStatus("VmRSS");
+
+	World w;
+	w.UseMappedStorage<Chunk>("MappedStorageCheck.swap", CompResidency::COLD);
+
+	std::vector<Entity> entities;
+	{
+		Prefab prefab;
+		prefab.Set<Chunk>(Chunk{});
+		for (std::size_t i = 0; i < ENTITY_NUM; i += TRIM_INTERVAL)
+		{
+			std::vector<Entity> batch = w.Instantiate(prefab, TRIM_INTERVAL);
+			entities.insert(entities.end(), batch.begin(), batch.end());
+			w.TrimColdComps();
+		}
+	}
+
+	auto start_time = std::chrono::steady_clock::now();
+	for (int pass = 0; pass < PASS_NUM; pass++)
+	{
+		for (std::size_t i = 0; i < entities.size(); i++)
+		{
+			Chunk& chunk = w.GetComp<Chunk>(entities[ i ]);
+			for (float& value : chunk.values)
+			{
+				value += 1.0f;
+			}
+			if ((i + 1) % TRIM_INTERVAL == 0)
+			{
+				w.TrimColdComps();
+			}
+		}
+	}
+	std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+	// 换出再读入后数据应保持不变
+	bool data_ok = true;
+	for (Entity entity : entities)
+	{
+		const Chunk& chunk = w.GetComp<Chunk>(entity);
+		if (chunk.values[ 0 ] != PASS_NUM || chunk.values[ 32767 ] != PASS_NUM)
+		{
+			data_ok = false;
+		}
+	}
+
+	double total_mb = static_cast<double>(entities.size() * sizeof(Chunk)) / (1 << 20);
+	std::size_t peak_rss = ReadProcStatus("VmHWM");
+	std::printf("components: %.0f MB, budget: %zu MB\n", total_mb, MEMORY_BUDGET >> 20);
+	std::printf("throughput: %.1f MB/s\n", total_mb * PASS_NUM / elapsed.count());
+
+	if (!data_ok)
+	{
+		std::printf("FAILED: component data changed after paging out\n");
+		return 1;
+	}
+	if (peak_rss == 0)
+	{
+		std::printf("peak resident memory is unavailable on this platform, skipped\n");
+		return 0;
+	}
+	std::printf("peak resident growth: %zu MB\n", (peak_rss - base_rss) >> 20);
+	if (peak_rss - base_rss > MEMORY_BUDGET)
+	{
+		std::printf("FAILED: resident memory exceeded the budget\n");
+		return 1;
+	}
+
+	return 0;
+}
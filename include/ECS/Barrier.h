@@ -0,0 +1,33 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+/*
+  可重复使用的线程屏障
+  C++17 中没有 std::barrier
+*/
+class Barrier
+{
+public:
+    /*
+      \param count 每次需要到达屏障的线程数量
+    */
+    explicit Barrier(std::size_t count);
+
+    /*
+      等待所有线程到达屏障
+    */
+    void Wait();
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    // 需要到达的线程数量
+    std::size_t m_count;
+    // 已经到达的线程数量
+    std::size_t m_arrived;
+    // 屏障被通过的次数，用来区分相邻两次等待
+    std::size_t m_generation;
+};
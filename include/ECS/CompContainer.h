@@ -1,10 +1,16 @@
 #pragma once
 
 #include <cassert>
+#include <cstddef>
+#include <cstring>
 #include <map>
 #include <array>
+#include <algorithm>
+#include <type_traits>
 #include "Types.h"
 
+class Prefab;
+
 /* 
   组件容器接口类
   组件容器模板类将会继承于此类
@@ -16,6 +22,36 @@ public:
     virtual ~ICompContainer() = default;
     // 移除容器内的一个组件
     virtual void RemoveComp(EntityId eid) = 0;
+    // 为一批尚未拥有此类型组件的实体添加相同的组件，comp 指向组件值
+    virtual void AddComps(const EntityId* eids, std::size_t n, const void* comp) = 0;
+    // 实体拥有此类型组件时，将组件复制到预制体中
+    virtual void ExportComp(EntityId eid, Prefab& prefab) = 0;
+    // 将不常访问的组件换出内存，只有部分存储方式支持
+    virtual void TrimCold() {}
+    // 每帧结束时交换前后台缓冲，只有部分存储方式支持
+    virtual void SwapBuffers() {}
+};
+
+/* 
+  组件存储接口类
+  这是一个模板类
+  不同存储方式的同类型组件容器都继承于此类
+  实体管理器通过此类访问具体类型的组件
+*/ 
+template<typename T>
+class ICompStorage : public ICompContainer
+{
+public:
+    // 向容器内添加一个组件
+    virtual void AddComp(EntityId eid, T comp) = 0;
+    // 获取容器内的一个组件，调用者可以修改组件
+    virtual T& GetComp(EntityId eid) = 0;
+    // 只读获取容器内的一个组件，不修改容器，可以在多个线程中同时调用
+    virtual const T& ReadComp(EntityId eid) { return GetComp(eid); }
+    // 检查容器内是否包含属于某个实体的组件
+    virtual bool HaveComp(EntityId eid) = 0;
+    // 实体拥有此类型组件时，将组件复制到预制体中，定义于 Prefab.h，由 EntityMngr.h 包含
+    void ExportComp(EntityId eid, Prefab& prefab) override;
 };
 
 /* 
@@ -25,7 +61,7 @@ public:
   并保证容器内的组件紧密存储
 */ 
 template<typename T>
-class CompContainer : public ICompContainer
+class CompContainer final : public ICompStorage<T>
 {
 public:
     /*
@@ -38,7 +74,7 @@ public:
       \param entity 组件所属实体
       \param comp   被添加的组件
     */ 
-    void AddComp(EntityId eid, T comp);
+    void AddComp(EntityId eid, T comp) override;
 
     /* 
       移除容器内的一个组件
@@ -50,17 +86,28 @@ public:
     */ 
     void RemoveComp(EntityId eid) override;
 
+    /* 
+      为一批实体添加相同的组件
+      重载自 ICompContainer
+      新组件连续存放在容器末尾
+      可平凡复制的组件直接以 memcpy 填充
+      \param eids 尚未拥有此类型组件的实体
+      \param n    实体数量
+      \param comp 指向组件值，类型为 const T*
+    */ 
+    void AddComps(const EntityId* eids, std::size_t n, const void* comp) override;
+
     /* 
       获取容器内的一个组件
       \param entity 要获取的组件所属的实体
     */ 
-    T& GetComp(EntityId eid);
+    T& GetComp(EntityId eid) override;
 
     /* 
       检查容器内是否包含属于某个实体的组件
       \param entity 待检查的实体
     */ 
-    bool HaveComp(EntityId eid);
+    bool HaveComp(EntityId eid) override;
 
 private:
     // 记录实体与其对应的组件在容器中的下标
@@ -115,6 +162,44 @@ void CompContainer<T>::RemoveComp(EntityId eid)
     }
 }
 
+template<typename T>
+void CompContainer<T>::AddComps(const EntityId* eids, std::size_t n, const void* comp)
+{
+    assert(m_current_comp_num + n <= MAX_COMP_NUM &&
+        "The number of components has reached the maximum!");
+
+    if (n == 0)
+    {
+        return ;
+    }
+
+    T* column = m_comps.data() + m_current_comp_num;
+    if constexpr (std::is_trivially_copyable<T>::value)
+    {
+        // 先写入一份，之后每次复制已填充的部分，复制次数为 log(n)
+        std::memcpy(column, comp, sizeof(T));
+        std::size_t filled = 1;
+        while (filled < n)
+        {
+            std::size_t count = std::min(filled, n - filled);
+            std::memcpy(column + filled, column, count * sizeof(T));
+            filled += count;
+        }
+    }
+    else
+    {
+        std::fill(column, column + n, *static_cast<const T*>(comp));
+    }
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        int idx = m_current_comp_num + static_cast<int>(i);
+        m_eid_to_idx.insert({eids[ i ], idx});
+        m_idx_to_eid.insert({idx, eids[ i ]});
+    }
+    m_current_comp_num += static_cast<int>(n);
+}
+
 template<typename T>
 T& CompContainer<T>::GetComp(EntityId eid)
 {
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+#include "Types.h"
+#include "CompContainer.h"
+
+template<typename T>
+class DoubleBufferedCompContainer;
+
+/*
+  前台缓冲视图
+  这是一个模板类
+  只读访问创建视图时最新发布的组件数据，可以在其他线程中使用
+  视图存在期间其读取的缓冲不会被修改，之后的交换发布到其他缓冲
+  视图不会跟随之后的交换更新，需要新数据时应释放并重新获取视图
+*/
+template<typename T>
+class FrontView
+{
+public:
+    explicit FrontView(DoubleBufferedCompContainer<T>* container);
+    ~FrontView();
+
+    FrontView(FrontView&& other) noexcept;
+    FrontView(const FrontView&) = delete;
+    FrontView& operator=(const FrontView&) = delete;
+    FrontView& operator=(FrontView&&) = delete;
+
+    /*
+      获取实体的组件
+      \return 组件指针，实体在视图读取的缓冲中没有此组件则返回 nullptr
+    */
+    const T* Get(Entity entity) const;
+
+    /*
+      判断实体在视图读取的缓冲中是否拥有此组件
+    */
+    bool Have(Entity entity) const;
+
+private:
+    DoubleBufferedCompContainer<T>* m_container;
+    // 视图读取的前台缓冲序号
+    int m_front;
+};
+
+/*
+  双缓冲组件容器类
+  这是一个模板类
+  后台缓冲与 CompContainer 一样紧密存储，供系统读写
+  前台缓冲共有三份，以实体下标存储组件副本，供其他线程只读访问
+  通过 GetComp 获取的组件视为已被修改，只读访问应使用 ReadComp
+  每帧结束时选出一份既不是最新发布、也没有视图在读取的前台缓冲
+  只将该缓冲上一次发布以来被修改过的组件复制进去，然后原子地将其发布为最新
+  读取线程总是拿到最新发布的缓冲，模拟线程与读取线程都不需要等待对方
+  只有两份旧缓冲都被长期持有的视图占用时才会跳过交换，修改记录保留到下一次交换
+*/
+template<typename T>
+class DoubleBufferedCompContainer final : public ICompStorage<T>
+{
+public:
+    DoubleBufferedCompContainer();
+
+    /*
+      向后台缓冲添加一个组件
+      重载自 ICompStorage
+    */
+    void AddComp(EntityId eid, T comp) override;
+
+    /*
+      为一批实体添加相同的组件
+      重载自 ICompContainer
+    */
+    void AddComps(const EntityId* eids, std::size_t n, const void* comp) override;
+
+    /*
+      从后台缓冲移除一个组件
+      重载自 ICompContainer
+    */
+    void RemoveComp(EntityId eid) override;
+
+    /*
+      获取后台缓冲中的组件，并将其标记为已修改
+      重载自 ICompStorage
+    */
+    T& GetComp(EntityId eid) override;
+
+    /*
+      只读获取后台缓冲中的组件，不标记为已修改
+      不修改容器，可以在多个线程中同时调用
+      重载自 ICompStorage
+    */
+    const T& ReadComp(EntityId eid) override;
+
+    /*
+      检查后台缓冲中是否包含属于某个实体的组件
+      重载自 ICompStorage
+    */
+    bool HaveComp(EntityId eid) override;
+
+    /*
+      将被修改过的组件复制到前台缓冲
+      重载自 ICompContainer
+    */
+    void SwapBuffers() override;
+
+    /*
+      获取最新发布的前台缓冲的只读视图
+      线程安全，不需要等待交换
+      持有视图的时间应不超过一帧，否则视图占用的缓冲不能用于发布
+      两个视图分别长期占用两份旧缓冲时，交换会一直被跳过，读取线程将看不到新数据
+    */
+    FrontView<T> ReadFront();
+
+private:
+    friend class FrontView<T>;
+
+    /*
+      将实体标记为已修改
+    */
+    void MarkDirty(EntityId eid);
+
+    // 一份前台缓冲
+    struct FrontBuffer
+    {
+        // 组件副本，以实体 ID 中的下标作为数组下标
+        std::vector<T> comps;
+        // 每个副本所属的实体，INVALID_ENTITY 表示没有组件
+        std::vector<Entity> eids;
+        // 自此缓冲上一次发布后被修改过的实体下标
+        std::vector<EntityId> dirty_indices;
+        // 实体下标是否已在 dirty_indices 中
+        std::vector<unsigned char> dirty_flags;
+        // 正在读取此缓冲的视图数量
+        std::atomic<int> readers;
+    };
+
+    // 表示实体未拥有此类型组件的下标
+    static constexpr int INVALID_IDX = -1;
+    // 前台缓冲的数量
+    static constexpr int FRONT_BUFFER_NUM = 3;
+
+    // 后台缓冲：记录实体与其对应的组件在容器中的下标，以实体 ID 中的下标作为数组下标
+    std::vector<int> m_eid_to_idx;
+    // 后台缓冲：与 m_eid_to_idx 相反
+    std::vector<EntityId> m_idx_to_eid;
+    // 后台缓冲：组件数组
+    std::vector<T> m_comps;
+
+    // 前台缓冲
+    std::array<FrontBuffer, FRONT_BUFFER_NUM> m_fronts;
+    // 最新发布的前台缓冲序号，只由模拟线程修改
+    std::atomic<int> m_published;
+};
+
+template<typename T>
+FrontView<T>::FrontView(DoubleBufferedCompContainer<T>* container)
+    : m_container(container), m_front(0)
+{
+    // 先登记为读取者再确认缓冲仍是最新发布的
+    // 模拟线程只会写入没有读取者的旧缓冲，因此确认之后缓冲不会再被修改
+    while (true)
+    {
+        int front = m_container->m_published.load();
+        m_container->m_fronts[ front ].readers.fetch_add(1);
+        if (m_container->m_published.load() == front)
+        {
+            m_front = front;
+            return ;
+        }
+        m_container->m_fronts[ front ].readers.fetch_sub(1);
+    }
+}
+
+template<typename T>
+FrontView<T>::~FrontView()
+{
+    if (m_container != nullptr)
+    {
+        m_container->m_fronts[ m_front ].readers.fetch_sub(1);
+    }
+}
+
+template<typename T>
+FrontView<T>::FrontView(FrontView&& other) noexcept
+    : m_container(other.m_container), m_front(other.m_front)
+{
+    other.m_container = nullptr;
+}
+
+template<typename T>
+const T* FrontView<T>::Get(Entity entity) const
+{
+    EntityId index = GetEntityIndex(entity);
+    const auto& front = m_container->m_fronts[ m_front ];
+    if (front.eids[ index ] != entity)
+    {
+        return nullptr;
+    }
+
+    return &front.comps[ index ];
+}
+
+template<typename T>
+bool FrontView<T>::Have(Entity entity) const
+{
+    return m_container->m_fronts[ m_front ].eids[ GetEntityIndex(entity) ] == entity;
+}
+
+template<typename T>
+DoubleBufferedCompContainer<T>::DoubleBufferedCompContainer()
+    : m_eid_to_idx(MAX_ENTITY_NUM, INVALID_IDX),
+      m_published(0)
+{
+    for (FrontBuffer& front : m_fronts)
+    {
+        front.comps.resize(MAX_ENTITY_NUM);
+        front.eids.assign(MAX_ENTITY_NUM, INVALID_ENTITY);
+        front.dirty_flags.assign(MAX_ENTITY_NUM, 0);
+        front.readers.store(0);
+    }
+}
+
+template<typename T>
+void DoubleBufferedCompContainer<T>::AddComp(EntityId eid, T comp)
+{
+    if (m_eid_to_idx[ GetEntityIndex(eid) ] != INVALID_IDX)
+    {
+        return ;
+    }
+
+    m_eid_to_idx[ GetEntityIndex(eid) ] = static_cast<int>(m_comps.size());
+    m_idx_to_eid.push_back(eid);
+    m_comps.push_back(std::move(comp));
+    MarkDirty(eid);
+}
+
+template<typename T>
+void DoubleBufferedCompContainer<T>::AddComps(const EntityId* eids, std::size_t n, const void* comp)
+{
+    for (std::size_t i = 0; i < n; i++)
+    {
+        AddComp(eids[ i ], *static_cast<const T*>(comp));
+    }
+}
+
+template<typename T>
+void DoubleBufferedCompContainer<T>::RemoveComp(EntityId eid)
+{
+    int removed_comp_index = m_eid_to_idx[ GetEntityIndex(eid) ];
+    if (removed_comp_index == INVALID_IDX || m_idx_to_eid[ removed_comp_index ] != eid)
+    {
+        return ;
+    }
+
+    // 用最后一个组件覆盖被删除的组件
+    EntityId last_comp_entity = m_idx_to_eid.back();
+    m_comps[ removed_comp_index ] = std::move(m_comps.back());
+    m_eid_to_idx[ GetEntityIndex(last_comp_entity) ] = removed_comp_index;
+    m_idx_to_eid[ removed_comp_index ] = last_comp_entity;
+    m_eid_to_idx[ GetEntityIndex(eid) ] = INVALID_IDX;
+    m_comps.pop_back();
+    m_idx_to_eid.pop_back();
+    MarkDirty(eid);
+}
+
+template<typename T>
+T& DoubleBufferedCompContainer<T>::GetComp(EntityId eid)
+{
+    int idx = m_eid_to_idx[ GetEntityIndex(eid) ];
+    assert(idx != INVALID_IDX && m_idx_to_eid[ idx ] == eid &&
+        "This entity does not own components of this type");
+
+    // 返回可写引用，视为组件将被修改
+    MarkDirty(eid);
+
+    return m_comps[ idx ];
+}
+
+template<typename T>
+const T& DoubleBufferedCompContainer<T>::ReadComp(EntityId eid)
+{
+    int idx = m_eid_to_idx[ GetEntityIndex(eid) ];
+    assert(idx != INVALID_IDX && m_idx_to_eid[ idx ] == eid &&
+        "This entity does not own components of this type");
+
+    return m_comps[ idx ];
+}
+
+template<typename T>
+bool DoubleBufferedCompContainer<T>::HaveComp(EntityId eid)
+{
+    int idx = m_eid_to_idx[ GetEntityIndex(eid) ];
+
+    return idx != INVALID_IDX && m_idx_to_eid[ idx ] == eid;
+}
+
+template<typename T>
+void DoubleBufferedCompContainer<T>::SwapBuffers()
+{
+    int published = m_published.load();
+    // 最新发布的缓冲之后没有修改
+    if (m_fronts[ published ].dirty_indices.empty())
+    {
+        return ;
+    }
+
+    for (int i = 0; i < FRONT_BUFFER_NUM; i++)
+    {
+        FrontBuffer& front = m_fronts[ i ];
+        if (i == published || front.readers.load() != 0)
+        {
+            continue;
+        }
+
+        // 只复制此缓冲上一次发布以来被修改的组件
+        for (EntityId index : front.dirty_indices)
+        {
+            int idx = m_eid_to_idx[ index ];
+            if (idx == INVALID_IDX)
+            {
+                front.eids[ index ] = INVALID_ENTITY;
+            }
+            else
+            {
+                front.comps[ index ] = m_comps[ idx ];
+                front.eids[ index ] = m_idx_to_eid[ idx ];
+            }
+            front.dirty_flags[ index ] = 0;
+        }
+        front.dirty_indices.clear();
+
+        m_published.store(i);
+        return ;
+    }
+    // 两份旧缓冲都在被读取，不等待，保留修改记录到下一次交换
+}
+
+template<typename T>
+FrontView<T> DoubleBufferedCompContainer<T>::ReadFront()
+{
+    return FrontView<T>(this);
+}
+
+template<typename T>
+void DoubleBufferedCompContainer<T>::MarkDirty(EntityId eid)
+{
+    // 每份前台缓冲分别记录，各自在被发布时复制
+    EntityId index = GetEntityIndex(eid);
+    for (FrontBuffer& front : m_fronts)
+    {
+        if (front.dirty_flags[ index ] == 0)
+        {
+            front.dirty_flags[ index ] = 1;
+            front.dirty_indices.push_back(index);
+        }
+    }
+}
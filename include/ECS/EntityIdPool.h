@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include "Types.h"
+
+/*
+  实体 ID 池
+  负责实体 ID 的分配与回收
+  空闲的实体下标保存在一个无锁栈中
+  因此 Allocate 与 Free 可以在多个线程中同时调用
+  每个下标都记录一个版本号，用来生成实体 ID 中的代数
+  被回收的实体 ID 再次分配时代数不同
+  过期的实体 ID 不会与新实体混淆
+*/
+class EntityIdPool
+{
+public:
+    EntityIdPool();
+
+    /*
+      分配一个实体 ID
+      线程安全
+      \return 分配到的实体 ID，没有可用 ID 时返回 INVALID_ENTITY
+    */
+    EntityId Allocate();
+
+    /*
+      回收一个实体 ID
+      线程安全
+      \return 实体是否存活，过期的实体 ID 不会被重复回收
+    */
+    bool Free(EntityId eid);
+
+    /*
+      分配一个实体 ID 并记录为预留状态
+      线程安全
+      预留的实体 ID 需要由 TakeReserved 取出后完成注册
+      在被取出之前不允许回收，IsAlive 也返回 false
+    */
+    EntityId Reserve();
+
+    /*
+      取出所有预留的实体 ID
+      只允许在一个线程中调用
+    */
+    std::vector<EntityId> TakeReserved();
+
+    /*
+      判断实体是否存活
+      只比较代数，时间复杂度为 O(1)
+      预留而尚未取出的实体视为不存活
+    */
+    bool IsAlive(EntityId eid) const;
+
+    /*
+      获取指定下标上存活的实体 ID
+      \return 该下标上的实体 ID，下标未被使用时返回 INVALID_ENTITY
+    */
+    EntityId GetEntityAt(EntityId index) const;
+
+private:
+    // 栈顶为 [ 高 32 位：防止 ABA 问题的标记 | 低 32 位：栈顶下标 ]
+    using StackHead = unsigned long long;
+
+    // 表示空栈的下标
+    static constexpr EntityId NIL_INDEX = ~0u;
+
+    /*
+      将下标压入栈中
+    */
+    void Push(std::atomic<StackHead>& head, EntityId index);
+
+    /*
+      从栈中弹出一个下标
+      \return 弹出的下标，空栈时返回 NIL_INDEX
+    */
+    EntityId Pop(std::atomic<StackHead>& head);
+
+    // 空闲下标栈
+    std::atomic<StackHead> m_free_head;
+    // 预留下标栈，与空闲下标栈共用 m_next
+    // 一个下标同一时刻只会处于其中一个栈中
+    std::atomic<StackHead> m_reserved_head;
+    // 每个下标在栈中的下一个下标
+    std::array<std::atomic<EntityId>, MAX_ENTITY_NUM> m_next;
+    // 每个下标的版本号，奇数表示存活，版本号右移一位即为代数
+    std::array<std::atomic<unsigned int>, MAX_ENTITY_NUM> m_versions;
+    // 每个下标是否处于预留状态
+    std::array<std::atomic<bool>, MAX_ENTITY_NUM> m_reserved;
+};
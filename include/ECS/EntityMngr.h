@@ -1,12 +1,18 @@
 #pragma once
 
-#include <queue>
 #include <map>
 #include <bitset>
 #include <memory>
 #include <set>
+#include <vector>
+#include <string>
 #include "Types.h"
+#include "EntityIdPool.h"
 #include "CompContainer.h"
+#include "MappedCompContainer.h"
+#include "DoubleBufferedCompContainer.h"
+
+class Prefab;
 
 /* 
   实体管理器
@@ -23,6 +29,51 @@ public:
     */ 
     EntityId CreateEntity();
 
+    /* 
+      预留一个实体 ID
+      线程安全，可以在并行执行的系统中调用
+      预留的实体需要调用 FlushReservedEntities 之后才能添加组件
+      在此之前视为不存活
+    */ 
+    EntityId ReserveEntity();
+
+    /* 
+      注册所有预留的实体
+      只允许在主线程调用
+      \return 被注册的实体
+    */ 
+    std::vector<EntityId> FlushReservedEntities();
+
+    /* 
+      判断实体是否存活
+      只比较实体 ID 中的代数，不需要查找索引
+    */ 
+    bool IsAlive(EntityId eid) const;
+
+    /* 
+      由预制体批量创建实体
+      每种组件的容器只查找一次，组件值批量复制
+      \param prefab 预制体
+      \param n      创建的实体数量
+      \return       被创建的实体
+    */ 
+    std::vector<EntityId> Instantiate(const Prefab& prefab, std::size_t n);
+
+    /* 
+      由一组组件类型相同的预制体批量创建实体，每个预制体创建一个实体
+      每种组件的容器只按第一个预制体查找一次，组件值分别复制
+      \param prefabs 组件类型及其顺序均相同的预制体
+      \return        被创建的实体，与 prefabs 一一对应
+    */ 
+    std::vector<EntityId> InstantiateEach(const std::vector<const Prefab*>& prefabs);
+
+    /* 
+      将实体的所有组件复制到预制体中
+      \param eid    源实体
+      \param prefab 接收组件的预制体
+    */ 
+    void ExportEntity(EntityId eid, Prefab& prefab);
+
     /* 
       销毁一个实体
       \param eid 需要销毁的实体 ID，EntityId 类型可直接使用 Entity 类型传参
@@ -69,7 +120,78 @@ public:
     template<typename T>
     T& GetComp(EntityId eid);
 
+    /* 
+      模板函数
+      只读获取实体的指定类型组件
+      不会将双缓冲组件标记为已修改
+      只进行查找，没有线程修改实体时可以在多个线程中同时调用
+    */ 
+    template<typename T>
+    const T& ReadComp(EntityId eid);
+
+    /* 
+      模板函数
+      获取指定类型组件的存储
+      需要对大量实体访问同一类型组件时，先获取存储再直接调用其方法，避免每次查找容器
+      存储中的组件只以实体 ID 索引，调用者需要保证实体存活
+      \return 组件存储，该类型的容器尚不存在时返回 nullptr
+    */ 
+    template<typename T>
+    ICompStorage<T>* GetStorage();
+
+    /* 
+      模板函数
+      指定类型的组件改为存储在内存映射文件中
+      需要在第一次添加该类型组件之前调用
+      \param path      映射文件的路径
+      \param residency 组件的驻留方式
+    */ 
+    template<typename T>
+    void UseMappedStorage(const std::string& path, CompResidency residency);
+
+    /* 
+      模板函数
+      修改存储在映射文件中的组件的驻留方式
+    */ 
+    template<typename T>
+    void SetCompResidency(CompResidency residency);
+
+    /* 
+      将所有驻留方式为 COLD 的组件换出内存
+    */ 
+    void TrimColdComps();
+
+    /* 
+      模板函数
+      指定类型的组件改为双缓冲存储
+      需要在第一次添加该类型组件之前调用
+      \return 双缓冲组件容器，可在其他线程中读取其前台缓冲
+    */ 
+    template<typename T>
+    std::shared_ptr<DoubleBufferedCompContainer<T> > UseDoubleBuffer();
+
+    /* 
+      交换所有双缓冲组件的前后台缓冲
+    */ 
+    void SwapCompBuffers();
+
 private:
+    friend class Prefab;
+
+    /* 
+      为新分配的实体建立索引信息
+      \param signature 实体的签名，默认为空
+    */ 
+    void RegisterEntity(EntityId eid, Signature signature = Signature());
+
+    /* 
+      模板函数
+      供预制体使用，获取组件类型 ID 以及对应的组件容器
+      容器不存在时进行创建
+    */ 
+    template<typename T>
+    static ICompContainer* ResolvePrefabComp(EntityMngr& mngr, CTID& comp_type_Id);
+
     /* 
       组件信息变化时，更新实体的签名信息
       \param eid                  目标实体
@@ -80,6 +202,7 @@ private:
 
     /* 
       获取到一个唯一的组件类型 ID
+      线程安全，所有世界共用同一套组件类型 ID
     */ 
     CTID GetUniqueCTID();
 
@@ -94,8 +217,8 @@ private:
 
     // 当前实体总数
     int m_entity_num;
-    // 当前可用的实体 ID
-    std::queue<EntityId> m_available_eids;
+    // 实体 ID 的分配与回收
+    EntityIdPool m_eid_pool;
     // 记录每个实体对应的签名
     std::map<EntityId, Signature> m_eid_to_signature;
     // 记录每种签名下已有的实体，键值为每种签名对应的数值型
@@ -112,6 +235,63 @@ CTID EntityMngr::GetCompTypeId()
     return comp_type_Id;
 }
 
+template<typename T>
+ICompContainer* EntityMngr::ResolvePrefabComp(EntityMngr& mngr, CTID& comp_type_Id)
+{
+    comp_type_Id = mngr.GetCompTypeId<T>();
+    const char* comp_type = typeid(T).name();
+    if (mngr.m_type_to_comp_container.find(comp_type) == mngr.m_type_to_comp_container.end())
+    {
+        mngr.m_type_to_comp_container.insert(
+            {comp_type, std::make_shared<CompContainer<T> >()}
+        );
+    }
+
+    return mngr.m_type_to_comp_container[ comp_type ].get();
+}
+
+template<typename T>
+void EntityMngr::UseMappedStorage(const std::string& path, CompResidency residency)
+{
+    const char* comp_type = typeid(T).name();
+    assert(m_type_to_comp_container.find(comp_type) == m_type_to_comp_container.end() &&
+        "The storage of this component type has already been created!");
+
+    // 确保组件类型已被注册
+    GetCompTypeId<T>();
+    m_type_to_comp_container.insert(
+        {comp_type, std::make_shared<MappedCompContainer<T> >(path, residency)}
+    );
+}
+
+template<typename T>
+void EntityMngr::SetCompResidency(CompResidency residency)
+{
+    const char* comp_type = typeid(T).name();
+    std::shared_ptr<MappedCompContainer<T> > comp_container
+        = std::dynamic_pointer_cast<MappedCompContainer<T> >(
+            m_type_to_comp_container[ comp_type ]
+    );
+    assert(comp_container != nullptr && "This component type is not stored in a mapped file!");
+
+    comp_container->SetResidency(residency);
+}
+
+template<typename T>
+std::shared_ptr<DoubleBufferedCompContainer<T> > EntityMngr::UseDoubleBuffer()
+{
+    const char* comp_type = typeid(T).name();
+    assert(m_type_to_comp_container.find(comp_type) == m_type_to_comp_container.end() &&
+        "The storage of this component type has already been created!");
+
+    GetCompTypeId<T>();
+    std::shared_ptr<DoubleBufferedCompContainer<T> > comp_container
+        = std::make_shared<DoubleBufferedCompContainer<T> >();
+    m_type_to_comp_container.insert({comp_type, comp_container});
+
+    return comp_container;
+}
+
 template<typename T>
 T& EntityMngr::AtachComp(EntityId eid, T comp)
 {
@@ -132,9 +312,9 @@ T& EntityMngr::AtachComp(EntityId eid, T comp)
         );
     }
 
-    // 将 ICompContainer 类智能指针转化为对应的模板容器类
-    std::shared_ptr<CompContainer<T> > comp_container
-        = std::static_pointer_cast<CompContainer<T> >(
+    // 将 ICompContainer 类智能指针转化为对应类型的组件存储
+    std::shared_ptr<ICompStorage<T> > comp_container
+        = std::static_pointer_cast<ICompStorage<T> >(
             m_type_to_comp_container[ comp_type ]
     );
 
@@ -161,8 +341,8 @@ void EntityMngr::DeAtachComp(EntityId eid)
 
     CTID current_CTID = GetCompTypeId<T>();
     const char* comp_type = typeid(T).name();
-    std::shared_ptr<CompContainer<T> > comp_container
-        = std::static_pointer_cast<CompContainer<T> >(
+    std::shared_ptr<ICompStorage<T> > comp_container
+        = std::static_pointer_cast<ICompStorage<T> >(
             m_type_to_comp_container[ comp_type ]
     );
 
@@ -186,8 +366,13 @@ bool EntityMngr::HaveComp(EntityId eid)
         "Entity does not exist");
 
     const char* comp_type = typeid(T).name();
-    std::shared_ptr<CompContainer<T> > comp_container
-        = std::static_pointer_cast<CompContainer<T> >(
+    // 该类型的组件容器尚不存在时，没有任何实体拥有此类型组件
+    if (m_type_to_comp_container.find(comp_type) == m_type_to_comp_container.end())
+    {
+        return false;
+    }
+    std::shared_ptr<ICompStorage<T> > comp_container
+        = std::static_pointer_cast<ICompStorage<T> >(
             m_type_to_comp_container[ comp_type ]
     );
 
@@ -202,8 +387,8 @@ T& EntityMngr::GetComp(EntityId eid)
 
     CTID current_CTID = GetCompTypeId<T>();
     const char* comp_type = typeid(T).name();
-    std::shared_ptr<CompContainer<T> > comp_container
-        = std::static_pointer_cast<CompContainer<T> >(
+    std::shared_ptr<ICompStorage<T> > comp_container
+        = std::static_pointer_cast<ICompStorage<T> >(
             m_type_to_comp_container[ comp_type ]
     );
 
@@ -212,3 +397,36 @@ T& EntityMngr::GetComp(EntityId eid)
 
     return comp_container->GetComp(eid);
 }
+
+template<typename T>
+const T& EntityMngr::ReadComp(EntityId eid)
+{
+    // 只使用 find，避免 operator[] 在多线程中插入元素
+    auto sig_iter = m_eid_to_signature.find(eid);
+    assert(sig_iter != m_eid_to_signature.end() && "Entity does not exist");
+    assert(sig_iter->second[ GetCompTypeId<T>() ] == 1 &&
+        "The component is not included in the entity!");
+    (void)sig_iter;
+
+    auto container_iter = m_type_to_comp_container.find(typeid(T).name());
+    ICompStorage<T>* comp_container = static_cast<ICompStorage<T>*>(container_iter->second.get());
+
+    return comp_container->ReadComp(eid);
+}
+
+template<typename T>
+ICompStorage<T>* EntityMngr::GetStorage()
+{
+    auto container_iter = m_type_to_comp_container.find(typeid(T).name());
+    if (container_iter == m_type_to_comp_container.end())
+    {
+        return nullptr;
+    }
+
+    return static_cast<ICompStorage<T>*>(container_iter->second.get());
+}
+
+// 组件容器的 ExportComp 需要完整的 Prefab 定义
+// Prefab.h 依赖本文件中的 EntityMngr，因此在末尾包含
+// 保证只包含本文件的代码也能实例化组件容器
+#include "Prefab.h"
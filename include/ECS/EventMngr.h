@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <array>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+#include <typeinfo>
+#include "Types.h"
+
+// 没有分配到独立缓冲的线程使用的共用缓冲下标
+const std::size_t SHARED_EVENT_SLOT = MAX_EVENT_THREAD_NUM;
+
+/*
+  事件视图
+  指向一段连续存储的事件
+  仅在下一次交换缓冲前有效
+*/
+template<typename E>
+using EventView = Span<E>;
+
+/*
+  事件队列接口类
+  事件队列模板类将会继承于此类
+  以支持在不确定类型时的声明
+*/
+class IEventQueue
+{
+public:
+    virtual ~IEventQueue() = default;
+    // 交换读写缓冲
+    virtual void Swap() = 0;
+};
+
+/*
+  事件队列类
+  一个队列只能存储一种类型的事件
+  每个线程写入自己的缓冲，互不竞争
+  没有分配到独立缓冲的线程共用一个加锁的缓冲
+  交换时将所有线程的缓冲合并到读缓冲中
+  缓冲只清空不释放，稳定运行后不再分配内存
+*/
+template<typename E>
+class EventQueue : public IEventQueue
+{
+public:
+    /*
+      在当前线程的写缓冲中构造一个事件
+      \param thread_slot 当前线程的缓冲下标，为 SHARED_EVENT_SLOT 时写入加锁的共用缓冲
+    */
+    template<typename... Args>
+    void Emit(std::size_t thread_slot, Args&&... args);
+
+    /*
+      获取上一次交换得到的所有事件
+    */
+    EventView<E> Read() const;
+
+    /*
+      交换读写缓冲
+      同一线程写入的事件保持写入顺序
+      重载自 IEventQueue
+    */
+    void Swap() override;
+
+private:
+    // 每个线程的写缓冲，按缓存行对齐以避免伪共享
+    struct alignas(64) ThreadBuffer
+    {
+        std::vector<E> events;
+    };
+
+    // 最后一个为共用缓冲
+    std::array<ThreadBuffer, MAX_EVENT_THREAD_NUM + 1> m_write_buffers;
+    // 保护共用缓冲
+    std::mutex m_shared_mutex;
+    // 读缓冲
+    std::vector<E> m_read_buffer;
+};
+
+/*
+  事件管理器
+  管理所有类型的事件队列
+  事件在一帧内写入，在下一帧读取
+*/
+class EventMngr
+{
+public:
+    /*
+      模板函数
+      注册一种事件类型
+      需要在主线程中调用，且先于该类型事件的发送
+    */
+    template<typename E>
+    void Register();
+
+    /*
+      模板函数
+      发送一个事件
+      线程安全，可以在并行执行的系统中调用
+      \param args 构造事件的参数
+    */
+    template<typename E, typename... Args>
+    void Emit(Args&&... args);
+
+    /*
+      模板函数
+      读取上一帧发送的指定类型事件
+    */
+    template<typename E>
+    EventView<E> Read();
+
+    /*
+      交换所有事件队列的读写缓冲
+      只允许在主线程调用
+    */
+    void Swap();
+
+private:
+    /*
+      获取当前线程的缓冲下标
+      每个线程第一次调用时分配一个唯一下标，线程退出时归还
+      下标用完时返回 SHARED_EVENT_SLOT
+    */
+    static std::size_t GetThreadSlot();
+
+    /*
+      模板函数
+      获取指定类型的事件队列
+    */
+    template<typename E>
+    EventQueue<E>& GetQueue();
+
+    // 存储不同类型的事件队列
+    std::map<const char*, std::shared_ptr<IEventQueue> > m_type_to_queue;
+};
+
+template<typename E>
+template<typename... Args>
+void EventQueue<E>::Emit(std::size_t thread_slot, Args&&... args)
+{
+    std::unique_lock<std::mutex> lock(m_shared_mutex, std::defer_lock);
+    if (thread_slot == SHARED_EVENT_SLOT)
+    {
+        lock.lock();
+    }
+
+    std::vector<E>& events = m_write_buffers[ thread_slot ].events;
+    // 聚合类型的事件无法直接原地构造，使用列表初始化
+    if constexpr (std::is_constructible<E, Args&&...>::value)
+    {
+        events.emplace_back(std::forward<Args>(args)...);
+    }
+    else
+    {
+        events.push_back(E{std::forward<Args>(args)...});
+    }
+}
+
+template<typename E>
+EventView<E> EventQueue<E>::Read() const
+{
+    return EventView<E>{m_read_buffer.data(), m_read_buffer.size()};
+}
+
+template<typename E>
+void EventQueue<E>::Swap()
+{
+    // 丢弃上一帧的事件，保留已分配的内存
+    m_read_buffer.clear();
+    for (ThreadBuffer& buffer : m_write_buffers)
+    {
+        m_read_buffer.insert(m_read_buffer.end(),
+            std::make_move_iterator(buffer.events.begin()),
+            std::make_move_iterator(buffer.events.end()));
+        buffer.events.clear();
+    }
+}
+
+template<typename E>
+void EventMngr::Register()
+{
+    const char* event_type = typeid(E).name();
+    if (m_type_to_queue.find(event_type) == m_type_to_queue.end())
+    {
+        m_type_to_queue.insert({event_type, std::make_shared<EventQueue<E> >()});
+    }
+}
+
+template<typename E, typename... Args>
+void EventMngr::Emit(Args&&... args)
+{
+    GetQueue<E>().Emit(GetThreadSlot(), std::forward<Args>(args)...);
+}
+
+template<typename E>
+EventView<E> EventMngr::Read()
+{
+    return GetQueue<E>().Read();
+}
+
+template<typename E>
+EventQueue<E>& EventMngr::GetQueue()
+{
+    // 此处只查找不插入，允许多个线程同时访问
+    auto iter = m_type_to_queue.find(typeid(E).name());
+    assert(iter != m_type_to_queue.end() &&
+        "This event type has not been registered!");
+
+    return *static_cast<EventQueue<E>*>(iter->second.get());
+}
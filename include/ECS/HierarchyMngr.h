@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "Types.h"
+
+/*
+  层级管理器
+  记录实体之间的父子关系
+  每个实体以 [ 第一个子实体 | 下一个兄弟实体 ] 的方式链接
+  同时维护一个按深度排列的实体序列
+  同一深度的实体连续存放，父实体总是先于子实体
+  因此沿层级传递数据时只需按深度逐层线性遍历
+*/
+class HierarchyMngr
+{
+public:
+    HierarchyMngr();
+
+    /*
+      设置实体的父实体
+      \param child  子实体
+      \param parent 父实体，为 INVALID_ENTITY 时使子实体脱离其父实体
+    */
+    void SetParent(Entity child, Entity parent);
+
+    /*
+      批量设置实体的父实体
+      深度序列只会在下一次访问时重建一次
+      \param child_parent_pairs [ 子实体 | 父实体 ] 列表
+    */
+    void SetParents(const std::vector<std::pair<Entity, Entity> >& child_parent_pairs);
+
+    /*
+      将实体从层级中移除
+      其子实体成为没有父实体的根实体
+    */
+    void Remove(Entity entity);
+
+    /*
+      获取实体的父实体
+      \return 父实体，没有父实体时返回 INVALID_ENTITY
+    */
+    Entity GetParent(Entity entity) const;
+
+    /*
+      获取实体的第一个子实体
+      \return 子实体，没有子实体时返回 INVALID_ENTITY
+    */
+    Entity GetFirstChild(Entity entity) const;
+
+    /*
+      获取实体的下一个兄弟实体
+      \return 兄弟实体，没有时返回 INVALID_ENTITY
+    */
+    Entity GetNextSibling(Entity entity) const;
+
+    /*
+      获取以指定实体为根的子树中的所有实体
+      父实体总是先于子实体，时间复杂度与子树大小成正比
+    */
+    std::vector<Entity> GetSubtree(Entity root) const;
+
+    /*
+      获取层级的最大深度加一
+    */
+    std::size_t GetLevelNum();
+
+    /*
+      获取指定深度的所有实体
+      深度 0 为根实体
+      返回的结果在下一次修改层级前有效
+    */
+    Span<Entity> GetLevel(std::size_t depth);
+
+private:
+    // 每个实体在层级中的链接，以实体 ID 中的下标作为数组下标
+    struct Node
+    {
+        // 节点对应的实体，INVALID_ENTITY 表示实体不在层级中
+        Entity entity;
+        Entity parent;
+        Entity first_child;
+        Entity next_sibling;
+        // 上一个兄弟实体，用来在 O(1) 时间内断开链接
+        Entity prev_sibling;
+        // 在 m_members 中的下标
+        std::size_t member_idx;
+    };
+
+    /*
+      判断实体是否在层级中
+    */
+    bool Contains(Entity entity) const;
+
+    /*
+      将实体加入层级
+    */
+    void Join(Entity entity);
+
+    /*
+      实体不再有任何父子关系时将其移出层级
+    */
+    void LeaveIfIsolated(Entity entity);
+
+    /*
+      断开实体与其父实体的链接
+    */
+    void Unlink(Entity child);
+
+    /*
+      按深度重建实体序列
+    */
+    void RebuildOrder();
+
+    // 所有实体的链接
+    std::vector<Node> m_nodes;
+    // 在层级中的所有实体
+    std::vector<Entity> m_members;
+    // 按深度排列的实体序列
+    std::vector<Entity> m_order;
+    // 每个深度在 m_order 中的起始位置，最后一项为 m_order 的大小
+    std::vector<std::size_t> m_level_offsets;
+    // 深度序列是否需要重建
+    bool m_order_dirty;
+};
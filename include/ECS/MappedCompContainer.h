@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "Types.h"
+#include "CompContainer.h"
+#include "MappedFile.h"
+
+/*
+  组件的驻留方式
+  决定映射文件中的组件是否允许被换出内存
+*/
+enum class CompResidency
+{
+    // 经常访问的组件，预先读入并保持驻留
+    HOT,
+    // 不常访问的组件，调用 TrimCold 时换出内存
+    COLD
+};
+
+/*
+  映射组件容器类
+  这是一个模板类
+  组件紧密存储在内存映射文件中，而不是进程的堆内存里
+  用于组件总量超过物理内存的世界
+  组件数组以页为单位增长，实体索引随实体下标增长
+  实体数量仍受 EntityIdPool 的 MAX_ENTITY_NUM 限制
+  需要大量实体时应同时增大 MAX_ENTITY_NUM，最大为 ENTITY_INDEX_MASK，即 2^20 - 1，约一百万
+  因此无法容纳千万级的实体，再增加需要扩大 ENTITY_INDEX_BITS，实体 ID 中的代数位随之减少
+  只支持可平凡复制的组件类型
+*/
+template<typename T>
+class MappedCompContainer final : public ICompStorage<T>
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+        "Only trivially copyable components can be stored in a mapped file!");
+
+public:
+    /*
+      \param path      映射文件的路径
+      \param residency 组件的驻留方式
+    */
+    MappedCompContainer(const std::string& path, CompResidency residency);
+
+    /*
+      向容器内添加一个组件
+      重载自 ICompStorage
+    */
+    void AddComp(EntityId eid, T comp) override;
+
+    /*
+      为一批实体添加相同的组件
+      重载自 ICompContainer
+    */
+    void AddComps(const EntityId* eids, std::size_t n, const void* comp) override;
+
+    /*
+      移除容器内的一个组件
+      使用最后一个组件填补空位，保证紧密存储
+      重载自 ICompContainer
+    */
+    void RemoveComp(EntityId eid) override;
+
+    /*
+      获取容器内的一个组件
+      重载自 ICompStorage
+    */
+    T& GetComp(EntityId eid) override;
+
+    /*
+      检查容器内是否包含属于某个实体的组件
+      重载自 ICompStorage
+    */
+    bool HaveComp(EntityId eid) override;
+
+    /*
+      驻留方式为 COLD 时将组件换出内存
+      重载自 ICompContainer
+    */
+    void TrimCold() override;
+
+    /*
+      修改组件的驻留方式
+    */
+    void SetResidency(CompResidency residency);
+
+private:
+    /*
+      保证容器至少能容纳 comp_num 个组件
+    */
+    void Reserve(std::size_t comp_num);
+
+    /*
+      获取实体在容器中的下标
+      \return 下标，实体未拥有此类型组件时返回 INVALID_IDX
+    */
+    int FindIndex(EntityId eid) const;
+
+    /*
+      映射文件中的组件数组
+    */
+    T* Comps() const { return static_cast<T*>(m_file.Data()); }
+
+    // 表示实体未拥有此类型组件的下标
+    static constexpr int INVALID_IDX = -1;
+
+    // 存储组件的映射文件
+    MappedFile m_file;
+    // 组件的驻留方式
+    CompResidency m_residency;
+    // 记录实体与其对应的组件在容器中的下标，以实体 ID 中的下标作为数组下标，按需增长
+    std::vector<int> m_eid_to_idx;
+    // 与 m_eid_to_idx 相反
+    std::vector<EntityId> m_idx_to_eid;
+    // 当前可容纳的组件数量
+    std::size_t m_capacity;
+};
+
+template<typename T>
+MappedCompContainer<T>::MappedCompContainer(const std::string& path, CompResidency residency)
+    : m_residency(residency), m_capacity(0)
+{
+    bool opened = m_file.Open(path);
+    assert(opened && "Failed to open the mapped file!");
+    (void)opened;
+}
+
+template<typename T>
+void MappedCompContainer<T>::AddComp(EntityId eid, T comp)
+{
+    AddComps(&eid, 1, &comp);
+}
+
+template<typename T>
+void MappedCompContainer<T>::AddComps(const EntityId* eids, std::size_t n, const void* comp)
+{
+    if (n == 0)
+    {
+        return ;
+    }
+
+    std::size_t first = m_idx_to_eid.size();
+    Reserve(first + n);
+    // 与 CompContainer 一样以倍增的 memcpy 填充
+    T* column = Comps() + first;
+    std::memcpy(column, comp, sizeof(T));
+    std::size_t filled = 1;
+    while (filled < n)
+    {
+        std::size_t count = std::min(filled, n - filled);
+        std::memcpy(column + filled, column, count * sizeof(T));
+        filled += count;
+    }
+
+    for (std::size_t i = 0; i < n; i++)
+    {
+        std::size_t index = GetEntityIndex(eids[ i ]);
+        if (index >= m_eid_to_idx.size())
+        {
+            m_eid_to_idx.resize(std::max(index + 1, m_eid_to_idx.size() * 2), INVALID_IDX);
+        }
+        assert(m_eid_to_idx[ index ] == INVALID_IDX &&
+            "This entity already owns a component of this type");
+        m_eid_to_idx[ index ] = static_cast<int>(first + i);
+        m_idx_to_eid.push_back(eids[ i ]);
+    }
+}
+
+template<typename T>
+void MappedCompContainer<T>::RemoveComp(EntityId eid)
+{
+    int removed_comp_index = FindIndex(eid);
+    if (removed_comp_index == INVALID_IDX)
+    {
+        return ;
+    }
+
+    std::size_t last_comp_index = m_idx_to_eid.size() - 1;
+    EntityId last_comp_entity = m_idx_to_eid[ last_comp_index ];
+    // 用最后一个组件覆盖被删除的组件
+    std::memcpy(Comps() + removed_comp_index, Comps() + last_comp_index, sizeof(T));
+    m_eid_to_idx[ GetEntityIndex(last_comp_entity) ] = removed_comp_index;
+    m_idx_to_eid[ removed_comp_index ] = last_comp_entity;
+    m_eid_to_idx[ GetEntityIndex(eid) ] = INVALID_IDX;
+    m_idx_to_eid.pop_back();
+}
+
+template<typename T>
+T& MappedCompContainer<T>::GetComp(EntityId eid)
+{
+    int idx = FindIndex(eid);
+    assert(idx != INVALID_IDX && "This entity does not own components of this type");
+
+    return Comps()[ idx ];
+}
+
+template<typename T>
+bool MappedCompContainer<T>::HaveComp(EntityId eid)
+{
+    return FindIndex(eid) != INVALID_IDX;
+}
+
+template<typename T>
+void MappedCompContainer<T>::TrimCold()
+{
+    if (m_residency == CompResidency::COLD)
+    {
+        m_file.AdvisePageOut();
+    }
+}
+
+template<typename T>
+void MappedCompContainer<T>::SetResidency(CompResidency residency)
+{
+    m_residency = residency;
+    if (m_residency == CompResidency::HOT)
+    {
+        m_file.AdviseWillNeed();
+    }
+    else
+    {
+        m_file.AdvisePageOut();
+    }
+}
+
+template<typename T>
+int MappedCompContainer<T>::FindIndex(EntityId eid) const
+{
+    std::size_t index = GetEntityIndex(eid);
+    if (index >= m_eid_to_idx.size())
+    {
+        return INVALID_IDX;
+    }
+    int idx = m_eid_to_idx[ index ];
+    if (idx == INVALID_IDX || m_idx_to_eid[ idx ] != eid)
+    {
+        return INVALID_IDX;
+    }
+
+    return idx;
+}
+
+template<typename T>
+void MappedCompContainer<T>::Reserve(std::size_t comp_num)
+{
+    if (comp_num <= m_capacity)
+    {
+        return ;
+    }
+
+    // 以页为单位按倍数增长
+    std::size_t new_capacity = std::max(comp_num, m_capacity * 2);
+    bool resized = m_file.Resize(new_capacity * sizeof(T));
+    assert(resized && "Failed to resize the mapped file!");
+    (void)resized;
+    m_capacity = m_file.Size() / sizeof(T);
+
+    // 组件紧密存储，遍历总是顺序访问
+    m_file.AdviseSequential();
+    if (m_residency == CompResidency::HOT)
+    {
+        m_file.AdviseWillNeed();
+    }
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/*
+  内存映射文件
+  封装不同平台的文件映射接口
+  文件仅作为组件的换页空间，关闭时删除
+  映射的大小总是页大小的整数倍
+*/
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /*
+      创建并打开一个文件，已存在的同名文件会被清空
+      \return 是否成功
+    */
+    bool Open(const std::string& path);
+
+    /*
+      调整文件大小并重新映射
+      原有数据保留，映射的地址可能改变
+      \param size 需要的字节数，会向上取整为页大小的整数倍
+      \return     是否成功
+    */
+    bool Resize(std::size_t size);
+
+    /*
+      关闭映射并删除文件
+    */
+    void Close();
+
+    // 映射的起始地址
+    void* Data() const { return m_data; }
+    // 映射的字节数
+    std::size_t Size() const { return m_size; }
+
+    /*
+      获取系统的页大小
+    */
+    static std::size_t GetPageSize();
+
+    /*
+      提示系统将按顺序访问映射的内存
+    */
+    void AdviseSequential();
+
+    /*
+      提示系统映射的内存即将被访问，应预先读入
+    */
+    void AdviseWillNeed();
+
+    /*
+      提示系统映射的内存暂时不会被访问，可以换出
+    */
+    void AdvisePageOut();
+
+private:
+    /*
+      按当前大小建立映射
+    */
+    bool Map();
+
+    /*
+      解除当前映射
+    */
+    void Unmap();
+
+    // 映射的起始地址
+    void* m_data;
+    // 映射的字节数
+    std::size_t m_size;
+#ifdef _WIN32
+    // 文件句柄
+    void* m_file;
+    // 文件映射对象句柄
+    void* m_mapping;
+#else
+    // 文件描述符
+    int m_fd;
+#endif
+};
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+#include "Types.h"
+#include "EntityMngr.h"
+
+/*
+  预制体类
+  记录一组组件及其默认值
+  可以通过 World::Instantiate 批量创建拥有这些组件的实体
+  可平凡复制的组件值紧密存放在同一块内存中
+  其他组件值单独保存一份副本
+*/
+class Prefab
+{
+public:
+    /*
+      模板函数
+      设置预制体中一个组件的默认值
+      重复设置同一类型组件时覆盖已有的值
+      \param comp 组件默认值
+    */
+    template<typename T>
+    Prefab& Set(T comp);
+
+    /*
+      模板函数
+      判断预制体是否包含指定类型的组件
+    */
+    template<typename T>
+    bool Have() const;
+
+    /*
+      判断两个预制体包含的组件类型及其顺序是否完全相同
+      相同的预制体可以共用一次组件容器查找，一起批量创建实体
+    */
+    bool SameCompTypes(const Prefab& other) const;
+
+private:
+    friend class EntityMngr;
+
+    // 预制体中一个组件的信息
+    struct CompRecord
+    {
+        // 组件类型的说明字符
+        const char* type_name;
+        // 获取组件类型 ID 以及对应的组件容器
+        ICompContainer* (*resolve)(EntityMngr& mngr, CTID& comp_type_Id);
+        // 可平凡复制的组件值在 m_blob 中的偏移
+        std::size_t offset;
+        // 不可平凡复制的组件值副本
+        std::shared_ptr<void> holder;
+    };
+
+    /*
+      获取组件默认值的地址
+    */
+    const void* GetCompData(const CompRecord& record) const;
+
+    // 预制体包含的组件
+    std::vector<CompRecord> m_records;
+    // 可平凡复制的组件值
+    std::vector<unsigned char> m_blob;
+};
+
+template<typename T>
+Prefab& Prefab::Set(T comp)
+{
+    const char* type_name = typeid(T).name();
+    CompRecord* record = nullptr;
+    for (CompRecord& existing : m_records)
+    {
+        if (existing.type_name == type_name)
+        {
+            record = &existing;
+        }
+    }
+
+    if constexpr (std::is_trivially_copyable<T>::value)
+    {
+        // 首次设置时在 m_blob 末尾按对齐要求分配空间
+        if (record == nullptr)
+        {
+            std::size_t offset = (m_blob.size() + alignof(T) - 1) / alignof(T) * alignof(T);
+            m_blob.resize(offset + sizeof(T));
+            m_records.push_back({type_name, &EntityMngr::ResolvePrefabComp<T>, offset, nullptr});
+            record = &m_records.back();
+        }
+        std::memcpy(m_blob.data() + record->offset, &comp, sizeof(T));
+    }
+    else
+    {
+        if (record == nullptr)
+        {
+            m_records.push_back({type_name, &EntityMngr::ResolvePrefabComp<T>, 0, nullptr});
+            record = &m_records.back();
+        }
+        // 重新创建副本，不影响由此预制体复制出的其他预制体
+        record->holder = std::make_shared<T>(std::move(comp));
+    }
+
+    return *this;
+}
+
+template<typename T>
+bool Prefab::Have() const
+{
+    const char* type_name = typeid(T).name();
+    for (const CompRecord& record : m_records)
+    {
+        if (record.type_name == type_name)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+template<typename T>
+void ICompStorage<T>::ExportComp(EntityId eid, Prefab& prefab)
+{
+    if (HaveComp(eid))
+    {
+        prefab.Set<T>(GetComp(eid));
+    }
+}
@@ -0,0 +1,664 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "Types.h"
+#include "Barrier.h"
+#include "SystemMngr.h"
+
+/*
+  位置组件的访问方式
+  默认读取组件的 x 和 y 成员
+  位置组件的成员不同时可以特化此模板
+*/
+template<typename P>
+struct PositionTraits
+{
+    static float GetX(const P& pos) { return pos.x; }
+    static float GetY(const P& pos) { return pos.y; }
+};
+
+/*
+  空间索引系统
+  这是一个模板类，P 为作为位置的组件类型
+  以哈希均匀网格组织拥有位置组件的实体
+  注册时使用包含位置组件的签名，与普通系统一样由世界维护其实体集合
+  每次更新只移动所在网格发生变化的实体，而不是重建整个索引
+  默认每次更新重新读取所有实体的位置
+  开启移动记录后只读取新加入的实体以及通过 MarkMoved 标记的实体的位置
+  查询时跳过已被销毁或移除了位置组件、但尚未从索引中移除的实体
+  对 StaticWorld 使用时，SystemBase 需指定为对应的 StaticWorld<...>::System
+*/
+template<typename P, typename SystemBase = System>
+class SpatialIndex : public SystemBase
+{
+public:
+    SpatialIndex();
+    ~SpatialIndex();
+
+    SpatialIndex(const SpatialIndex&) = delete;
+    SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+    /*
+      设置网格的边长
+      下一次更新时会重建索引
+    */
+    void SetCellSize(float cell_size);
+
+    /*
+      设置计算实体所在网格时使用的线程数量
+      工作线程在此创建并一直保留到下一次设置或系统销毁
+      多线程计算时只读取位置组件，此时不能有其他线程修改世界
+    */
+    void SetThreadNum(unsigned int thread_num);
+
+    /*
+      设置是否只更新被标记为已移动的实体
+      开启后修改位置组件的系统需要调用 MarkMoved，否则实体不会在索引中移动
+    */
+    void SetMoveTracking(bool enable);
+
+    /*
+      标记实体的位置已经改变
+      只在开启移动记录时生效，不是线程安全的
+    */
+    void MarkMoved(Entity entity);
+
+    /*
+      增量更新索引
+      重载自 System
+    */
+    void OnUpdate(float dt) override;
+
+    /*
+      清空并重建整个索引
+    */
+    void Rebuild();
+
+    /*
+      查询与指定点距离不超过 radius 的实体
+      返回的结果在下一次查询前有效
+    */
+    Span<Entity> QueryRadius(float x, float y, float radius);
+
+    /*
+      查询位于轴对齐包围盒内的实体
+      返回的结果在下一次查询前有效
+    */
+    Span<Entity> QueryAABB(float min_x, float min_y, float max_x, float max_y);
+
+    /*
+      查询距离指定点最近的 k 个实体，按距离从近到远排列
+      返回的结果在下一次查询前有效
+    */
+    Span<Entity> QueryNearest(float x, float y, std::size_t k);
+
+private:
+    // 网格的键值，由网格坐标拼接而成
+    using CellKey = unsigned long long;
+
+    // 每个实体在索引中的信息，以实体 ID 中的下标作为数组下标
+    struct EntityRecord
+    {
+        // 记录中的实体，INVALID_ENTITY 表示未被索引
+        Entity entity;
+        // 实体所在的网格
+        CellKey cell;
+        // 实体最后一次被更新时的帧序号，用来找出已离开系统的实体
+        unsigned int frame;
+        // 实体是否已在 m_moved 中
+        bool moved;
+    };
+
+    /*
+      将坐标转换为网格坐标
+    */
+    int ToCellCoord(float value) const;
+
+    /*
+      由网格坐标获得网格键值
+    */
+    static CellKey MakeCellKey(int cell_x, int cell_y);
+
+    /*
+      找出需要重新计算网格的实体，保存在 m_current_cells 中
+      同时记录系统当前关注的所有实体
+    */
+    void CollectChanged();
+
+    /*
+      计算 m_current_cells 中的实体当前所在的网格
+    */
+    void ComputeCells();
+
+    /*
+      计算 m_current_cells 中一段实体所在的网格
+    */
+    void ComputeCellRange(std::size_t begin, std::size_t end);
+
+    /*
+      工作线程的主循环
+      \param worker 工作线程的序号，从 1 开始，当前线程为 0
+    */
+    void RunWorker(std::size_t worker);
+
+    /*
+      结束所有工作线程
+    */
+    void StopWorkers();
+
+    /*
+      判断索引中的实体是否仍然可以读取位置组件
+    */
+    bool IsQueryable(Entity entity);
+
+    /*
+      根据 m_current_cells 更新索引
+    */
+    void ApplyCells();
+
+    /*
+      将实体从网格中移除
+    */
+    void RemoveFromCell(Entity entity, CellKey cell);
+
+    /*
+      模板函数
+      遍历网格坐标范围内的所有实体
+      \return 访问到的索引记录数量，包括被跳过的实体
+    */
+    template<typename F>
+    std::size_t ForEachInRange(int min_cell_x, int min_cell_y, int max_cell_x, int max_cell_y, F func);
+
+    // 网格边长
+    float m_cell_size;
+    // 计算网格时使用的线程数量
+    unsigned int m_thread_num;
+    // 是否只更新被标记为已移动的实体
+    bool m_track_moves;
+    // 是否需要在下一次更新时重建索引
+    bool m_need_rebuild;
+    // 当前帧序号
+    unsigned int m_frame;
+    // 所有非空网格中的实体
+    std::unordered_map<CellKey, std::vector<Entity> > m_cells;
+    // 实体在索引中的信息
+    std::array<EntityRecord, MAX_ENTITY_NUM> m_records;
+    // 上一次更新后在索引中的实体
+    std::vector<Entity> m_indexed;
+    // 本次更新后在索引中的实体
+    std::vector<Entity> m_next_indexed;
+    // 被标记为已移动的实体
+    std::vector<Entity> m_moved;
+    // 本次更新中需要重新计算网格的实体及其所在的网格
+    std::vector<std::pair<Entity, CellKey> > m_current_cells;
+    // 工作线程，不包括当前线程
+    std::vector<std::thread> m_workers;
+    // 当前线程与工作线程在计算开始与结束时同步
+    std::unique_ptr<Barrier> m_barrier;
+    // 每个线程处理的实体数量
+    std::size_t m_chunk;
+    // 工作线程是否需要退出
+    bool m_stop_workers;
+    // 查询结果
+    std::vector<Entity> m_result;
+    // 最近邻查询的候选实体及其距离的平方
+    std::vector<std::pair<float, Entity> > m_candidates;
+};
+
+template<typename P, typename SystemBase>
+SpatialIndex<P, SystemBase>::SpatialIndex()
+    : m_cell_size(1.0f), m_thread_num(1), m_track_moves(false), m_need_rebuild(false),
+      m_frame(0), m_chunk(0), m_stop_workers(false)
+{
+    m_records.fill(EntityRecord{INVALID_ENTITY, 0, 0, false});
+}
+
+template<typename P, typename SystemBase>
+SpatialIndex<P, SystemBase>::~SpatialIndex()
+{
+    StopWorkers();
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::SetCellSize(float cell_size)
+{
+    assert(cell_size > 0.0f && "Cell size must be positive!");
+
+    m_cell_size = cell_size;
+    m_need_rebuild = true;
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::SetThreadNum(unsigned int thread_num)
+{
+    StopWorkers();
+    m_thread_num = std::max(1u, thread_num);
+    if (m_thread_num == 1)
+    {
+        return ;
+    }
+
+    m_barrier = std::make_unique<Barrier>(m_thread_num);
+    for (std::size_t worker = 1; worker < m_thread_num; worker++)
+    {
+        m_workers.emplace_back(&SpatialIndex::RunWorker, this, worker);
+    }
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::SetMoveTracking(bool enable)
+{
+    m_track_moves = enable;
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::MarkMoved(Entity entity)
+{
+    EntityRecord& record = m_records[ GetEntityIndex(entity) ];
+    // 尚未被索引的实体会在下一次更新时作为新实体加入
+    if (!m_track_moves || record.entity != entity || record.moved)
+    {
+        return ;
+    }
+
+    record.moved = true;
+    m_moved.push_back(entity);
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::OnUpdate(float dt)
+{
+    if (m_need_rebuild)
+    {
+        Rebuild();
+        return ;
+    }
+
+    CollectChanged();
+    ComputeCells();
+    ApplyCells();
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::Rebuild()
+{
+    m_cells.clear();
+    for (Entity entity : m_indexed)
+    {
+        m_records[ GetEntityIndex(entity) ].entity = INVALID_ENTITY;
+    }
+    m_indexed.clear();
+    for (Entity entity : m_moved)
+    {
+        m_records[ GetEntityIndex(entity) ].moved = false;
+    }
+    m_moved.clear();
+    m_need_rebuild = false;
+
+    CollectChanged();
+    ComputeCells();
+    ApplyCells();
+}
+
+template<typename P, typename SystemBase>
+Span<Entity> SpatialIndex<P, SystemBase>::QueryRadius(float x, float y, float radius)
+{
+    m_result.clear();
+    float radius_sq = radius * radius;
+    ForEachInRange(ToCellCoord(x - radius), ToCellCoord(y - radius),
+        ToCellCoord(x + radius), ToCellCoord(y + radius),
+        [&](Entity entity, const P& pos) {
+            float dx = PositionTraits<P>::GetX(pos) - x;
+            float dy = PositionTraits<P>::GetY(pos) - y;
+            if (dx * dx + dy * dy <= radius_sq)
+            {
+                m_result.push_back(entity);
+            }
+        });
+
+    return Span<Entity>{m_result.data(), m_result.size()};
+}
+
+template<typename P, typename SystemBase>
+Span<Entity> SpatialIndex<P, SystemBase>::QueryAABB(float min_x, float min_y, float max_x, float max_y)
+{
+    m_result.clear();
+    ForEachInRange(ToCellCoord(min_x), ToCellCoord(min_y),
+        ToCellCoord(max_x), ToCellCoord(max_y),
+        [&](Entity entity, const P& pos) {
+            float px = PositionTraits<P>::GetX(pos);
+            float py = PositionTraits<P>::GetY(pos);
+            if (px >= min_x && px <= max_x && py >= min_y && py <= max_y)
+            {
+                m_result.push_back(entity);
+            }
+        });
+
+    return Span<Entity>{m_result.data(), m_result.size()};
+}
+
+template<typename P, typename SystemBase>
+Span<Entity> SpatialIndex<P, SystemBase>::QueryNearest(float x, float y, std::size_t k)
+{
+    m_result.clear();
+    m_candidates.clear();
+    if (k == 0 || m_indexed.empty())
+    {
+        return Span<Entity>{m_result.data(), 0};
+    }
+
+    int center_x = ToCellCoord(x);
+    int center_y = ToCellCoord(y);
+    // 访问过的索引记录数量，包括被跳过的实体
+    std::size_t visited = 0;
+    auto visit = [&](Entity entity, const P& pos) {
+        float dx = PositionTraits<P>::GetX(pos) - x;
+        float dy = PositionTraits<P>::GetY(pos) - y;
+        m_candidates.push_back({dx * dx + dy * dy, entity});
+    };
+
+    // 由近及远逐圈搜索网格
+    // 第 ring 圈之外的实体与查询点的距离一定大于 ring * m_cell_size
+    for (int ring = 0; ; ring++)
+    {
+        if (ring == 0)
+        {
+            visited += ForEachInRange(center_x, center_y, center_x, center_y, visit);
+        }
+        else
+        {
+            // 上下两行
+            visited += ForEachInRange(center_x - ring, center_y - ring, center_x + ring, center_y - ring, visit);
+            visited += ForEachInRange(center_x - ring, center_y + ring, center_x + ring, center_y + ring, visit);
+            // 左右两列，不包含四个角
+            visited += ForEachInRange(center_x - ring, center_y - ring + 1, center_x - ring, center_y + ring - 1, visit);
+            visited += ForEachInRange(center_x + ring, center_y - ring + 1, center_x + ring, center_y + ring - 1, visit);
+        }
+
+        // 所有实体均已被访问
+        if (visited == m_indexed.size())
+        {
+            break;
+        }
+        // 实体分布稀疏时逐圈搜索的网格数会超过非空网格数，改为直接遍历所有实体
+        if (static_cast<std::size_t>(ring) * ring > m_cells.size())
+        {
+            m_candidates.clear();
+            for (Entity entity : m_indexed)
+            {
+                if (IsQueryable(entity))
+                {
+                    visit(entity, this->world->template ReadComp<P>(entity));
+                }
+            }
+            break;
+        }
+        if (m_candidates.size() >= k)
+        {
+            std::nth_element(m_candidates.begin(), m_candidates.begin() + (k - 1), m_candidates.end());
+            float searched = ring * m_cell_size;
+            if (m_candidates[ k - 1 ].first <= searched * searched)
+            {
+                break;
+            }
+        }
+    }
+
+    std::size_t result_num = std::min(k, m_candidates.size());
+    std::partial_sort(m_candidates.begin(), m_candidates.begin() + result_num, m_candidates.end());
+    for (std::size_t i = 0; i < result_num; i++)
+    {
+        m_result.push_back(m_candidates[ i ].second);
+    }
+
+    return Span<Entity>{m_result.data(), m_result.size()};
+}
+
+template<typename P, typename SystemBase>
+int SpatialIndex<P, SystemBase>::ToCellCoord(float value) const
+{
+    return static_cast<int>(std::floor(value / m_cell_size));
+}
+
+template<typename P, typename SystemBase>
+typename SpatialIndex<P, SystemBase>::CellKey SpatialIndex<P, SystemBase>::MakeCellKey(int cell_x, int cell_y)
+{
+    return (static_cast<CellKey>(static_cast<unsigned int>(cell_x)) << 32)
+        | static_cast<unsigned int>(cell_y);
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::CollectChanged()
+{
+    m_frame += 1;
+    m_current_cells.clear();
+    m_next_indexed.clear();
+    for (Entity entity : this->entities)
+    {
+        m_next_indexed.push_back(entity);
+        EntityRecord& record = m_records[ GetEntityIndex(entity) ];
+        // 未开启移动记录时重新计算所有实体，否则只计算新加入的实体
+        if (!m_track_moves || record.entity != entity)
+        {
+            m_current_cells.push_back({entity, 0});
+        }
+        else
+        {
+            record.frame = m_frame;
+        }
+    }
+
+    for (Entity entity : m_moved)
+    {
+        EntityRecord& record = m_records[ GetEntityIndex(entity) ];
+        record.moved = false;
+        // 已离开系统的实体不再读取位置，由 ApplyCells 移除
+        if (record.entity == entity && record.frame == m_frame)
+        {
+            m_current_cells.push_back({entity, 0});
+        }
+    }
+    m_moved.clear();
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::ComputeCells()
+{
+    std::size_t total = m_current_cells.size();
+    if (m_workers.empty() || total < m_thread_num)
+    {
+        ComputeCellRange(0, total);
+        return ;
+    }
+
+    // 每个线程处理连续的一段实体，当前线程处理第一段
+    m_chunk = (total + m_thread_num - 1) / m_thread_num;
+    m_barrier->Wait();
+    ComputeCellRange(0, std::min(m_chunk, total));
+    m_barrier->Wait();
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::ComputeCellRange(std::size_t begin, std::size_t end)
+{
+    for (std::size_t i = begin; i < end; i++)
+    {
+        const P& pos = this->world->template ReadComp<P>(m_current_cells[ i ].first);
+        m_current_cells[ i ].second = MakeCellKey(
+            ToCellCoord(PositionTraits<P>::GetX(pos)),
+            ToCellCoord(PositionTraits<P>::GetY(pos)));
+    }
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::RunWorker(std::size_t worker)
+{
+    while (true)
+    {
+        m_barrier->Wait();
+        if (m_stop_workers)
+        {
+            return ;
+        }
+
+        std::size_t total = m_current_cells.size();
+        std::size_t begin = std::min(worker * m_chunk, total);
+        ComputeCellRange(begin, std::min(begin + m_chunk, total));
+        m_barrier->Wait();
+    }
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::StopWorkers()
+{
+    if (m_workers.empty())
+    {
+        return ;
+    }
+
+    // 放行等待在计算开始处的工作线程，使其退出
+    m_stop_workers = true;
+    m_barrier->Wait();
+    for (std::thread& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+    m_barrier.reset();
+    m_stop_workers = false;
+}
+
+template<typename P, typename SystemBase>
+bool SpatialIndex<P, SystemBase>::IsQueryable(Entity entity)
+{
+    return this->world->IsAlive(entity) && this->world->template HaveComp<P>(entity);
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::ApplyCells()
+{
+    for (const auto& pair : m_current_cells)
+    {
+        Entity entity = pair.first;
+        CellKey cell = pair.second;
+        EntityRecord& record = m_records[ GetEntityIndex(entity) ];
+        if (record.entity != entity)
+        {
+            // 下标被新实体复用，先移除旧实体
+            if (record.entity != INVALID_ENTITY)
+            {
+                RemoveFromCell(record.entity, record.cell);
+            }
+            m_cells[ cell ].push_back(entity);
+            record.entity = entity;
+            record.cell = cell;
+        }
+        else if (record.cell != cell)
+        {
+            // 只有所在网格变化的实体需要移动
+            RemoveFromCell(entity, record.cell);
+            m_cells[ cell ].push_back(entity);
+            record.cell = cell;
+        }
+        record.frame = m_frame;
+    }
+
+    // 移除已离开系统的实体
+    for (Entity entity : m_indexed)
+    {
+        EntityRecord& record = m_records[ GetEntityIndex(entity) ];
+        if (record.entity == entity && record.frame != m_frame)
+        {
+            RemoveFromCell(entity, record.cell);
+            record.entity = INVALID_ENTITY;
+        }
+    }
+
+    m_indexed.swap(m_next_indexed);
+}
+
+template<typename P, typename SystemBase>
+void SpatialIndex<P, SystemBase>::RemoveFromCell(Entity entity, CellKey cell)
+{
+    auto cell_iter = m_cells.find(cell);
+    if (cell_iter == m_cells.end())
+    {
+        return ;
+    }
+
+    std::vector<Entity>& cell_entities = cell_iter->second;
+    auto iter = std::find(cell_entities.begin(), cell_entities.end(), entity);
+    if (iter != cell_entities.end())
+    {
+        // 用最后一个实体填补空位
+        *iter = cell_entities.back();
+        cell_entities.pop_back();
+    }
+    // 空网格立即删除，m_cells 的大小始终等于非空网格数，查询时据此选择遍历方式
+    if (cell_entities.empty())
+    {
+        m_cells.erase(cell_iter);
+    }
+}
+
+template<typename P, typename SystemBase>
+template<typename F>
+std::size_t SpatialIndex<P, SystemBase>::ForEachInRange(int min_cell_x, int min_cell_y, int max_cell_x, int max_cell_y, F func)
+{
+    std::size_t visited = 0;
+    // 范围内的网格数多于非空网格数时，直接遍历所有非空网格
+    long long range_cell_num = (static_cast<long long>(max_cell_x) - min_cell_x + 1)
+        * (static_cast<long long>(max_cell_y) - min_cell_y + 1);
+    if (range_cell_num > static_cast<long long>(m_cells.size()))
+    {
+        for (const auto& pair : m_cells)
+        {
+            int cell_x = static_cast<int>(pair.first >> 32);
+            int cell_y = static_cast<int>(static_cast<unsigned int>(pair.first));
+            if (cell_x < min_cell_x || cell_x > max_cell_x ||
+                cell_y < min_cell_y || cell_y > max_cell_y)
+            {
+                continue;
+            }
+            for (Entity entity : pair.second)
+            {
+                if (IsQueryable(entity))
+                {
+                    func(entity, this->world->template ReadComp<P>(entity));
+                }
+            }
+            visited += pair.second.size();
+        }
+        return visited;
+    }
+
+    for (int cell_x = min_cell_x; cell_x <= max_cell_x; cell_x++)
+    {
+        for (int cell_y = min_cell_y; cell_y <= max_cell_y; cell_y++)
+        {
+            auto iter = m_cells.find(MakeCellKey(cell_x, cell_y));
+            if (iter == m_cells.end())
+            {
+                continue;
+            }
+            for (Entity entity : iter->second)
+            {
+                if (IsQueryable(entity))
+                {
+                    func(entity, this->world->template ReadComp<P>(entity));
+                }
+            }
+            visited += iter->second.size();
+        }
+    }
+
+    return visited;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <cassert>
+#include <array>
+#include "Types.h"
+
+/*
+  静态组件容器类
+  供 StaticWorld 使用的具体组件存储
+  与 CompContainer 一样保证容器内的组件紧密存储
+  不同之处在于不继承 ICompContainer，没有虚函数调用
+  并使用以实体下标为下标的数组代替 std::map 记录索引
+  因此查询组件只需要两次数组访问
+*/
+template<typename T>
+class StaticCompContainer
+{
+public:
+    /*
+      初始化容器内组件数量为 0
+      并将所有实体标记为未拥有组件
+    */
+    StaticCompContainer() : m_current_comp_num(0)
+    {
+        m_eid_to_idx.fill(INVALID_IDX);
+    }
+
+    /*
+      向容器内添加一个组件
+      \param eid  组件所属实体
+      \param comp 被添加的组件
+    */
+    void AddComp(EntityId eid, T comp);
+
+    /*
+      移除容器内的一个组件
+      使用最后一个组件填补空位，保证紧密存储
+      \param eid 要移除的组件所属的实体
+    */
+    void RemoveComp(EntityId eid);
+
+    /*
+      获取容器内的一个组件
+      \param eid 要获取的组件所属的实体
+    */
+    T& GetComp(EntityId eid);
+
+    /*
+      检查容器内是否包含属于某个实体的组件
+      \param eid 待检查的实体
+    */
+    bool HaveComp(EntityId eid) const;
+
+    /*
+      获取拥有此类型组件的所有实体
+      顺序与组件在容器中的存储顺序一致
+    */
+    Span<EntityId> GetEntities() const;
+
+private:
+    // 表示实体未拥有此类型组件的下标
+    static constexpr int INVALID_IDX = -1;
+
+    // 记录实体与其对应的组件在容器中的下标，以实体 ID 中的下标作为数组下标
+    std::array<int, MAX_ENTITY_NUM> m_eid_to_idx;
+    // 与 m_eid_to_idx 相反
+    std::array<EntityId, MAX_COMP_NUM> m_idx_to_eid;
+    // 组件数组
+    std::array<T, MAX_COMP_NUM> m_comps;
+    // 当前的组件数量
+    int m_current_comp_num;
+};
+
+template<typename T>
+void StaticCompContainer<T>::AddComp(EntityId eid, T comp)
+{
+    // 该实体未拥有此种类型组件时添加才会生效
+    if (m_eid_to_idx[ GetEntityIndex(eid) ] == INVALID_IDX)
+    {
+        int idx = m_current_comp_num;
+        m_eid_to_idx[ GetEntityIndex(eid) ] = idx;
+        m_idx_to_eid[ idx ] = eid;
+        m_comps[ idx ] = std::move(comp);
+        m_current_comp_num += 1;
+    }
+}
+
+template<typename T>
+void StaticCompContainer<T>::RemoveComp(EntityId eid)
+{
+    // 该实体拥有此种组件时移除才会生效
+    if (m_eid_to_idx[ GetEntityIndex(eid) ] != INVALID_IDX)
+    {
+        int removed_comp_index = m_eid_to_idx[ GetEntityIndex(eid) ];
+        int last_comp_index = m_current_comp_num - 1;
+        EntityId last_comp_entity = m_idx_to_eid[ last_comp_index ];
+        // 用最后一个组件覆盖被删除的组件
+        m_comps[ removed_comp_index ] = std::move(m_comps[ last_comp_index ]);
+        // 更新最后组件被移动后对应实体的索引信息
+        m_eid_to_idx[ GetEntityIndex(last_comp_entity) ] = removed_comp_index;
+        m_idx_to_eid[ removed_comp_index ] = last_comp_entity;
+        // 移除索引信息
+        m_eid_to_idx[ GetEntityIndex(eid) ] = INVALID_IDX;
+        // 计数更新
+        m_current_comp_num -= 1;
+    }
+}
+
+template<typename T>
+T& StaticCompContainer<T>::GetComp(EntityId eid)
+{
+    // 如果该实体未拥有此类型组件则报错
+    int idx = m_eid_to_idx[ GetEntityIndex(eid) ];
+    assert(idx != INVALID_IDX &&
+        "This entity does not own components of this type");
+
+    return m_comps[ idx ];
+}
+
+template<typename T>
+bool StaticCompContainer<T>::HaveComp(EntityId eid) const
+{
+    return m_eid_to_idx[ GetEntityIndex(eid) ] != INVALID_IDX;
+}
+
+template<typename T>
+Span<EntityId> StaticCompContainer<T>::GetEntities() const
+{
+    return {m_idx_to_eid.data(), static_cast<std::size_t>(m_current_comp_num)};
+}
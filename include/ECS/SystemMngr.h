@@ -2,7 +2,10 @@
 
 #include <map>
 #include <set>
+#include <vector>
 #include <memory>
+#include <cassert>
+#include <typeinfo>
 #include "Types.h"
 
 // 系统类需要使用到一个系统类的指针
@@ -28,6 +31,37 @@ enum class UpdateEntitiesType
     ENTITY_SIGNATURE_UPDATED
 };
 
+/* 
+  系统所属的更新阶段
+  每帧按枚举顺序依次执行各阶段的系统
+*/ 
+enum class SystemPhase
+{
+    // 每帧最先执行一次
+    PRE_UPDATE,
+    // 以固定时间步长执行，一帧内可能执行零次或多次
+    FIXED_UPDATE,
+    // 每帧执行一次，默认阶段
+    UPDATE,
+    // 每帧最后执行一次
+    POST_UPDATE
+};
+
+/* 
+  系统的调度方式
+*/ 
+struct SystemSchedule
+{
+    // 系统所属的更新阶段
+    SystemPhase phase = SystemPhase::UPDATE;
+    // 每经过多少次阶段更新执行一次系统，传入的 dt 为这期间的总时间
+    unsigned int rate_divider = 1;
+    // 时间分片数量，大于 1 时实体分为 time_slices 组，每次执行轮到其中一组
+    // 实体加入系统时被分到实体最少的一组，各组实体数量至多相差 1
+    // 系统需要遍历 System::slice 而不是 entities，每个实体每 time_slices 次执行被处理一次
+    unsigned int time_slices = 1;
+};
+
 /* 
   系统基类
   用户自定义的系统需要继承自此类
@@ -35,7 +69,7 @@ enum class UpdateEntitiesType
 */ 
 struct System
 {
-    System() : world(nullptr) {}
+    System() : world(nullptr), slice_dt(0.0f) {}
     // 此函数用来更新一次系统逻辑
     virtual void OnUpdate(float dt) {}
 
@@ -43,6 +77,11 @@ struct System
     World* world;
     // 系统关注的实体
     std::set<Entity> entities;
+    // 使用时间分片时，本次执行轮到的一组实体，系统应只处理这些实体
+    std::vector<Entity> slice;
+    // 使用时间分片时，本组实体距离上一次被处理经过的时间
+    // 第一次处理时为系统注册以来经过的时间
+    float slice_dt;
 };
 
 /* 
@@ -60,12 +99,21 @@ public:
       会获取当前系统关注的所有实体
       \param signature   关注的实体签名，用来决定系统关注哪些实体
       \param entity_mngr 和系统处于同一世界的实体管理器
+      \param schedule    系统的调度方式
     */ 
     template<typename T>
-    void Register(Signature signature, World* world);
+    void Register(Signature signature, World* world, SystemSchedule schedule = SystemSchedule());
+
+    /* 
+      设置 FIXED_UPDATE 阶段的固定时间步长
+      \param step      固定时间步长
+      \param max_steps 每帧最多执行的固定步数，避免单帧耗时过长后越积越多
+    */ 
+    void SetFixedTimeStep(float step, unsigned int max_steps = 8);
 
     /* 
       更新所有系统
+      按阶段依次执行，FIXED_UPDATE 阶段使用累加器以固定步长执行
       \param dt 当前帧与上一帧的间隔时间
     */ 
     void Update(float dt);
@@ -81,6 +129,21 @@ public:
     */ 
     void UpdateEntities(UpdateEntitiesType update_type, Entity entity, Signature signature);
 
+    /* 
+      将一批签名相同的新实体加入关注它们的系统
+      每个系统只比较一次签名
+      \param entities  新创建的实体
+      \param signature 实体的签名
+    */ 
+    void AddEntities(const std::vector<Entity>& entities, Signature signature);
+
+    /* 
+      获取一个已注册的系统
+      这是一个模板函数
+    */ 
+    template<class T>
+    T& GetSystem();
+
     /*
       这是提供给 World 类调用的函数
       以确保 World 注册一个系统时可以为其设置实体集合
@@ -89,14 +152,73 @@ public:
     void SetEntities(std::set<Entity> entities);
 
 private:
+    // 每个系统的调度状态
+    struct ScheduleState
+    {
+        SystemSchedule schedule;
+        // 距离上一次执行经过的阶段更新次数
+        unsigned int tick;
+        // 距离上一次执行经过的时间
+        float elapsed;
+        // 时间分片时本次执行轮到的组
+        unsigned int slice_group;
+        // 每组实体距离上一次被处理经过的时间
+        std::vector<float> group_elapsed;
+        // 时间分片时每组的实体
+        std::vector<std::vector<Entity> > groups;
+        // 时间分片时 [ 实体 | 所在的组及其在组内的位置 ]
+        std::map<Entity, std::pair<unsigned int, std::size_t> > entity_slots;
+    };
+
+    /* 
+      执行一个阶段内的所有系统
+    */ 
+    void UpdatePhase(SystemPhase phase, float dt);
+
+    /* 
+      按调度方式执行一个系统
+    */ 
+    void RunSystem(ScheduleState& state, System& system, float dt);
+
+    /* 
+      实体加入系统时，将其分到实体最少的一组
+      只对时间分片的系统生效
+    */ 
+    void JoinSlice(ScheduleState& state, Entity entity);
+
+    /* 
+      实体离开系统时，将其从所在的组中移除
+      该组因此比最大的组少 2 个实体时，从最大的组移动一个实体过来
+      被移动的实体下一次被处理的时间会提前或推迟，但不会被遗漏
+    */ 
+    void LeaveSlice(ScheduleState& state, Entity entity);
+
+    /* 
+      重新为系统关注的所有实体分组
+    */ 
+    void ResetSlices(ScheduleState& state, const std::set<Entity>& entities);
+
+    /* 
+      将组内指定位置的实体移出组，以组内最后一个实体填补空位
+    */ 
+    void RemoveFromGroup(ScheduleState& state, unsigned int group, std::size_t pos);
+
     // 每个系统关注的实体签名，用来决定系统关注哪些实体
     std::map<const char*, Signature> m_type_to_signature;
     // 被注册的系统
     std::map<const char*, std::shared_ptr<System> > m_type_to_system;
+    // 每个系统的调度状态
+    std::map<const char*, ScheduleState> m_type_to_schedule;
+    // FIXED_UPDATE 阶段的固定时间步长
+    float m_fixed_step = 1.0f / 60.0f;
+    // 每帧最多执行的固定步数
+    unsigned int m_max_fixed_steps = 8;
+    // 尚未被固定步消耗的时间
+    float m_fixed_accumulator = 0.0f;
 };
 
 template<class T>
-void SystemMngr::Register(Signature signature, World* world)
+void SystemMngr::Register(Signature signature, World* world, SystemSchedule schedule)
 {
     // 若当前类不是继承自 System 则报错
     static_assert(
@@ -109,6 +231,13 @@ void SystemMngr::Register(Signature signature, World* world)
     {
         m_type_to_signature.insert({type_name, signature});
         m_type_to_system.insert({type_name, std::make_shared<T>()});
+
+        assert(schedule.rate_divider > 0 && schedule.time_slices > 0 &&
+            "Rate divider and time slices must be positive!");
+        ScheduleState state{schedule, 0, 0.0f, 0,
+            std::vector<float>(schedule.time_slices, 0.0f),
+            std::vector<std::vector<Entity> >(schedule.time_slices), {}};
+        m_type_to_schedule.insert({type_name, std::move(state)});
     }
     // 记录实体管理器
     m_type_to_system.find(type_name)->second->world = world;
@@ -119,5 +248,17 @@ void SystemMngr::SetEntities(std::set<Entity> entities)
 {
     const char* type_name = typeid(T).name();
     // 更新系统订阅的实体集合
-    m_type_to_system.find(type_name)->second->entities = entities;
+    std::shared_ptr<System>& system = m_type_to_system.find(type_name)->second;
+    system->entities = std::move(entities);
+    ResetSlices(m_type_to_schedule[ type_name ], system->entities);
+}
+
+template<class T>
+T& SystemMngr::GetSystem()
+{
+    const char* type_name = typeid(T).name();
+    auto iter = m_type_to_system.find(type_name);
+    assert(iter != m_type_to_system.end() && "This system has not been registered!");
+
+    return *static_cast<T*>(iter->second.get());
 }
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <type_traits>
+#include "Types.h"
+
+// 编译期类型列表相关的工具
+
+/*
+  判断类型 T 是否存在于类型列表 Ts 中
+*/
+template<typename T, typename... Ts>
+struct TypeContains : std::disjunction<std::is_same<T, Ts>...> {};
+
+/*
+  获取类型 T 在类型列表 Ts 中的下标
+  此下标在编译期确定，可直接作为组件类型 ID 使用
+  若 T 不在列表中则编译失败，使用前请先通过 TypeContains 检查
+*/
+template<typename T, typename... Ts>
+struct TypeIndex;
+
+template<typename T, typename... Rest>
+struct TypeIndex<T, T, Rest...> : std::integral_constant<CTID, 0> {};
+
+template<typename T, typename U, typename... Rest>
+struct TypeIndex<T, U, Rest...>
+    : std::integral_constant<CTID, 1 + TypeIndex<T, Rest...>::value> {};
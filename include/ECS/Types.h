@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bitset>
+#include <cstddef>
 
 // 需要使用到的一些全局的类型或变量
 
@@ -10,12 +11,61 @@ const int MAX_COMP_NUM = 1000;
 const int MAX_ENTITY_NUM = 1000;
 // 最大组件类型数量
 const int MAX_COMP_TYPE_NUM = 64;
+// 拥有独立事件缓冲的最大线程数量，更多的线程共用一个加锁的缓冲
+const int MAX_EVENT_THREAD_NUM = 16;
 
 // 组件类型 ID
 using CTID = unsigned int;
 // 实体 ID，用来唯一标识一个实体
+// 低位存储实体下标，高位存储实体下标被复用的代数
 using EntityId = unsigned int;
 // 实体即是一个 ID
 using Entity = EntityId;
 // 实体的签名，用来描述一个组件拥有哪些实体
 using Signature = std::bitset<MAX_COMP_TYPE_NUM>;
+
+// 实体 ID 中下标所占的位数，其余高位为代数
+const int ENTITY_INDEX_BITS = 20;
+// 实体下标掩码
+const EntityId ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+// 实体代数掩码（右移后）
+const EntityId ENTITY_GENERATION_MASK = ~0u >> ENTITY_INDEX_BITS;
+// 无效的实体 ID
+const EntityId INVALID_ENTITY = ~0u;
+
+static_assert(MAX_ENTITY_NUM <= ENTITY_INDEX_MASK,
+    "MAX_ENTITY_NUM does not fit in the index bits of EntityId!");
+
+// 获取实体 ID 中的下标
+constexpr EntityId GetEntityIndex(EntityId eid)
+{
+    return eid & ENTITY_INDEX_MASK;
+}
+
+// 获取实体 ID 中的代数
+constexpr EntityId GetEntityGeneration(EntityId eid)
+{
+    return eid >> ENTITY_INDEX_BITS;
+}
+
+// 由下标和代数组成实体 ID
+constexpr EntityId MakeEntityId(EntityId index, EntityId generation)
+{
+    return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | index;
+}
+
+/*
+  只读视图
+  指向一段连续存储的元素，不持有内存
+*/
+template<typename T>
+struct Span
+{
+    const T* begin() const { return data; }
+    const T* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+    const T& operator[](std::size_t i) const { return data[ i ]; }
+
+    const T* data;
+    std::size_t size;
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "World.h"
+#include "ECS/Barrier.h"
+
+/*
+  分片管理器
+  管理多个世界，每个世界作为一个分片运行在自己的线程中
+  每帧依次经过以下阶段，阶段之间以屏障同步：
+    1. 更新阶段：所有分片并行调用 World::Update
+    2. 消息阶段：交换每个分片的消息缓冲，导出需要迁移的实体
+    3. 迁移阶段：每个分片创建迁入的实体
+  实体 ID 只在所属分片内有效，迁移后会得到新的 ID
+*/
+class ShardMngr
+{
+public:
+    /*
+      \param shard_num 分片数量，每个分片占用一个线程
+    */
+    explicit ShardMngr(std::size_t shard_num);
+    ~ShardMngr();
+
+    ShardMngr(const ShardMngr&) = delete;
+    ShardMngr& operator=(const ShardMngr&) = delete;
+
+    /*
+      获取分片数量
+    */
+    std::size_t GetShardNum() const;
+
+    /*
+      获取一个分片
+      分片的实体与系统需要在两次 Update 之间设置
+    */
+    World& GetShard(std::size_t shard);
+
+    /*
+      请求将实体迁移到另一个分片
+      实体连同其所有组件在本帧的迁移阶段被批量转移
+      实体的父子关系不会随之迁移
+      只允许在分片 from 的系统中或两次 Update 之间调用
+      \param from   实体当前所属的分片
+      \param entity 需要迁移的实体
+      \param to     目标分片
+    */
+    void Migrate(std::size_t from, Entity entity, std::size_t to);
+
+    /*
+      设置实体迁移完成时的回调
+      在目标分片的线程中调用，可用来更新引用了旧实体 ID 的数据
+      \param on_migrate 形如 void(std::size_t from, Entity old_entity, std::size_t to, Entity new_entity) 的函数
+    */
+    void SetMigrateCallback(
+        const std::function<void(std::size_t, Entity, std::size_t, Entity)>& on_migrate);
+
+    /*
+      模板函数
+      注册一种跨分片消息类型
+      需要在两次 Update 之间调用，且先于该类型消息的发送
+    */
+    template<typename M>
+    void RegisterMessage();
+
+    /*
+      模板函数
+      向一个分片发送消息
+      线程安全，可以在任意分片的系统中调用
+      分片数量超过 MAX_EVENT_THREAD_NUM 时，部分分片线程共用一个加锁的缓冲
+      消息在本帧的消息阶段送达，目标分片在下一帧读取
+      \param to   目标分片
+      \param args 构造消息的参数
+    */
+    template<typename M, typename... Args>
+    void Send(std::size_t to, Args&&... args);
+
+    /*
+      模板函数
+      读取分片在上一次消息阶段收到的消息
+      只允许在该分片的系统中或两次 Update 之间调用
+    */
+    template<typename M>
+    EventView<M> ReadMessages(std::size_t shard);
+
+    /*
+      更新所有分片
+      返回时所有分片都已完成本帧的全部阶段
+      \param dt 当前帧与上一帧的间隔时间
+    */
+    void Update(float dt);
+
+private:
+    // 一个等待迁入的实体
+    struct Transfer
+    {
+        // 实体在源分片中的 ID
+        Entity entity;
+        // 实体的所有组件
+        Prefab comps;
+    };
+
+    /*
+      分片线程的主循环
+    */
+    void RunShard(std::size_t shard);
+
+    /*
+      导出分片请求迁出的实体，并将其从分片中销毁
+    */
+    void ExportMigrations(std::size_t shard);
+
+    /*
+      在分片中创建迁入的实体
+      所有来源的迁入实体一起创建，组件类型相同的实体为一批
+    */
+    void ImportMigrations(std::size_t shard);
+
+    // 所有分片
+    std::vector<std::unique_ptr<World> > m_shards;
+    // 每个分片收到的消息
+    std::vector<std::unique_ptr<EventMngr> > m_inboxes;
+    // 每个分片请求迁出的 [ 实体 | 目标分片 ]，只由源分片写入
+    std::vector<std::vector<std::pair<Entity, std::size_t> > > m_migrate_requests;
+    // 迁移队列，下标为 目标分片 * 分片数量 + 源分片，每个队列只由一个线程写入
+    std::vector<std::vector<Transfer> > m_transfers;
+    // 实体迁移完成时的回调
+    std::function<void(std::size_t, Entity, std::size_t, Entity)> m_on_migrate;
+    // 分片线程
+    std::vector<std::thread> m_threads;
+    // 主线程与分片线程在帧开始与结束时同步
+    Barrier m_frame_barrier;
+    // 分片线程在阶段之间同步
+    Barrier m_phase_barrier;
+    // 本帧的间隔时间
+    float m_dt;
+    // 分片线程是否继续运行
+    bool m_running;
+};
+
+template<typename M>
+void ShardMngr::RegisterMessage()
+{
+    for (auto& inbox : m_inboxes)
+    {
+        inbox->Register<M>();
+    }
+}
+
+template<typename M, typename... Args>
+void ShardMngr::Send(std::size_t to, Args&&... args)
+{
+    assert(to < m_inboxes.size() && "The shard does not exist!");
+
+    m_inboxes[ to ]->Emit<M>(std::forward<Args>(args)...);
+}
+
+template<typename M>
+EventView<M> ShardMngr::ReadMessages(std::size_t shard)
+{
+    assert(shard < m_inboxes.size() && "The shard does not exist!");
+
+    return m_inboxes[ shard ]->Read<M>();
+}
@@ -0,0 +1,641 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <memory>
+#include <set>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <typeinfo>
+#include "ECS/Types.h"
+#include "ECS/TypeList.h"
+#include "ECS/EntityIdPool.h"
+#include "ECS/EventMngr.h"
+#include "ECS/HierarchyMngr.h"
+#include "ECS/StaticCompContainer.h"
+
+template<typename... Comps>
+class StaticWorld;
+
+/*
+  静态世界的系统基类
+  与 System 的用法一致
+  用户自定义的系统需要继承自 StaticWorld<...>::System
+*/
+template<typename... Comps>
+struct StaticSystem
+{
+    StaticSystem() : world(nullptr) {}
+    virtual ~StaticSystem() = default;
+    // 此函数用来更新一次系统逻辑
+    virtual void OnUpdate(float dt) {}
+
+    // 系统所属的世界，用来操作实体
+    StaticWorld<Comps...>* world;
+    // 系统关注的实体
+    std::set<Entity> entities;
+};
+
+/*
+  静态世界类
+  组件类型集合在编译期确定的世界
+  组件类型 ID 即为组件在模板参数中的下标
+  所有组件容器以 std::tuple 存储具体类型
+  因此访问组件时不需要 typeid、std::map 查找和虚函数调用
+  实体与组件的接口与 World 相同
+  系统仍在运行时注册，与 World 一样以类型名查找、以虚函数更新、以 std::set 记录关注的实体
+  需要编译期确定的遍历时使用 Each，它不经过系统
+  系统不支持 SystemSchedule，所有系统每帧按注册顺序各执行一次
+*/
+template<typename... Comps>
+class StaticWorld
+{
+    static_assert(sizeof...(Comps) <= MAX_COMP_TYPE_NUM,
+        "The number of component types exceeds the maximum!");
+
+public:
+    // 此世界对应的系统基类
+    using System = StaticSystem<Comps...>;
+
+    StaticWorld();
+
+    /*
+      模板函数
+      获取一个组件的类型 ID，在编译期确定
+    */
+    template<typename T>
+    static constexpr CTID GetCompTypeId();
+
+    /*
+      模板函数
+      获取由指定组件类型组成的签名，在编译期确定
+    */
+    template<typename... Cs>
+    static constexpr Signature GetSignature();
+
+    /*
+      创建一个实体
+    */
+    Entity CreateEntity();
+
+    /*
+      预留一个实体
+      线程安全，可以在并行执行的系统中调用
+      与 World 一致，预留的实体在调用 FlushReservedEntities 之后才能添加组件
+      在此之前 IsAlive 返回 false，也无法被销毁
+    */
+    Entity ReserveEntity();
+
+    /*
+      注册所有预留的实体
+      只允许在主线程调用，例如在两次 Update 之间
+    */
+    void FlushReservedEntities();
+
+    /*
+      判断实体是否存活
+    */
+    bool IsAlive(Entity entity) const;
+
+    /*
+      销毁一个实体
+    */
+    void DestroyEntity(Entity entity);
+
+    /*
+      销毁一个实体及其所有后代实体
+    */
+    void DestroySubtree(Entity root);
+
+    /*
+      设置实体的父实体
+      \param parent 父实体，为 INVALID_ENTITY 时使实体脱离其父实体
+    */
+    void SetParent(Entity child, Entity parent);
+
+    /*
+      批量设置实体的父实体
+      \param child_parent_pairs [ 子实体 | 父实体 ] 列表
+    */
+    void SetParents(const std::vector<std::pair<Entity, Entity> >& child_parent_pairs);
+
+    /*
+      获取实体的父实体
+    */
+    Entity GetParent(Entity entity) const;
+
+    /*
+      获取一个实体的签名
+    */
+    Signature GetEntitySignature(Entity entity);
+
+    /*
+      根据签名获取实体集合
+    */
+    std::set<EntityId> GetEntities(Signature signature);
+
+    /*
+      模板函数
+      向一个实体添加组件
+    */
+    template<typename T>
+    T& AtachComp(Entity entity, T comp);
+
+    /*
+      模板函数
+      从实体中移除组件
+    */
+    template<typename T>
+    void DeAtachComp(Entity entity);
+
+    /*
+      模板函数
+      获取到实体的组件
+    */
+    template<typename T>
+    T& GetComp(Entity entity);
+
+    /*
+      模板函数
+      只读获取实体的组件
+      与 World 的接口一致，静态世界的组件容器读写没有区别
+    */
+    template<typename T>
+    const T& ReadComp(Entity entity);
+
+    /*
+      模板函数
+      查询一个实体是否拥有组件
+    */
+    template<typename T>
+    bool HaveComp(Entity entity);
+
+    /*
+      模板函数
+      沿层级由父到子传递组件数据
+      \param func 形如 void(const T& parent, T& child) 的函数
+    */
+    template<typename T, typename F>
+    void PropagateHierarchy(F func);
+
+    /*
+      模板函数
+      遍历同时拥有组件 Cs 的所有实体
+      参与遍历的容器在编译期确定，只遍历其中组件数量最少的一个，其余容器以数组查询
+      没有 typeid、std::map 查找和虚函数调用，也不需要注册系统
+      func 中不允许增删 Cs 类型的组件或销毁实体
+      \param func 形如 void(Entity entity, Cs&... comps) 的函数
+    */
+    template<typename... Cs, typename F>
+    void Each(F func);
+
+    /*
+      模板函数
+      注册一个系统
+      与 World 不同，不接受 SystemSchedule 参数，系统每帧执行一次
+      \param signature 系统关注的实体签名
+    */
+    template<typename T>
+    void RegisterSys(Signature signature);
+
+    /*
+      模板函数
+      注册一个系统，关注的签名由组件类型 Cs 在编译期计算
+    */
+    template<typename T, typename... Cs>
+    void RegisterSys();
+
+    /*
+      模板函数
+      获取一个已注册的系统
+    */
+    template<typename T>
+    T& GetSys();
+
+    /*
+      模板函数
+      注册一种事件类型
+    */
+    template<typename E>
+    void RegisterEvent();
+
+    /*
+      模板函数
+      发送一个事件
+      线程安全，事件在下一帧才能被读取
+    */
+    template<typename E, typename... Args>
+    void Emit(Args&&... args);
+
+    /*
+      模板函数
+      读取上一帧发送的指定类型事件
+    */
+    template<typename E>
+    EventView<E> ReadEvents();
+
+    /*
+      更新一帧
+      之后交换事件缓冲，本帧发送的事件在下一帧可读
+      \param dt 当前帧与上一帧的间隔时间
+    */
+    void Update(float dt);
+
+private:
+    // 被注册的系统及其关注的签名
+    struct SystemEntry
+    {
+        const char* type_name;
+        Signature signature;
+        std::shared_ptr<System> system;
+    };
+
+    /*
+      实体签名变化时，更新所有系统关注的实体集合
+    */
+    void UpdateSystemEntities(Entity entity, Signature signature);
+
+    /*
+      模板函数
+      获取指定类型组件的容器
+    */
+    template<typename T>
+    StaticCompContainer<T>& GetContainer();
+
+    // 所有组件容器，数量较大所以放在堆上
+    std::unique_ptr<std::tuple<StaticCompContainer<Comps>...> > m_containers;
+    // 实体 ID 的分配与回收
+    EntityIdPool m_eid_pool;
+    // 记录每个实体对应的签名，以实体 ID 中的下标作为数组下标
+    std::vector<Signature> m_signatures;
+    // 被注册的系统
+    std::vector<SystemEntry> m_systems;
+    // 事件管理器
+    EventMngr m_event_mngr;
+    // 层级管理器
+    HierarchyMngr m_hierarchy_mngr;
+};
+
+template<typename... Comps>
+StaticWorld<Comps...>::StaticWorld()
+    : m_containers(std::make_unique<std::tuple<StaticCompContainer<Comps>...> >()),
+      m_signatures(MAX_ENTITY_NUM)
+{
+}
+
+template<typename... Comps>
+template<typename T>
+constexpr CTID StaticWorld<Comps...>::GetCompTypeId()
+{
+    static_assert(TypeContains<T, Comps...>::value,
+        "This component type is not registered in the StaticWorld!");
+
+    return TypeIndex<T, Comps...>::value;
+}
+
+template<typename... Comps>
+template<typename... Cs>
+constexpr Signature StaticWorld<Comps...>::GetSignature()
+{
+    return Signature((0ULL | ... | (1ULL << GetCompTypeId<Cs>())));
+}
+
+template<typename... Comps>
+Entity StaticWorld<Comps...>::CreateEntity()
+{
+    EntityId eid = m_eid_pool.Allocate();
+    assert(eid != INVALID_ENTITY &&
+        "The number of entities has reached the maximum!");
+
+    return eid;
+}
+
+template<typename... Comps>
+Entity StaticWorld<Comps...>::ReserveEntity()
+{
+    EntityId eid = m_eid_pool.Reserve();
+    assert(eid != INVALID_ENTITY &&
+        "The number of entities has reached the maximum!");
+
+    return eid;
+}
+
+template<typename... Comps>
+void StaticWorld<Comps...>::FlushReservedEntities()
+{
+    // 实体签名以实体下标存储，回收时已置空，取出后即可使用
+    m_eid_pool.TakeReserved();
+}
+
+template<typename... Comps>
+bool StaticWorld<Comps...>::IsAlive(Entity entity) const
+{
+    return m_eid_pool.IsAlive(entity);
+}
+
+template<typename... Comps>
+void StaticWorld<Comps...>::DestroyEntity(Entity entity)
+{
+    if (!m_eid_pool.IsAlive(entity))
+    {
+        return ;
+    }
+
+    // 实体的子实体成为根实体
+    m_hierarchy_mngr.Remove(entity);
+    // 清除属于该实体的组件
+    std::apply([entity](auto&... containers) {
+        (containers.RemoveComp(entity), ...);
+    }, *m_containers);
+    // 将实体从所有系统的实体集合中移除
+    for (auto& entry : m_systems)
+    {
+        entry.system->entities.erase(entity);
+    }
+    // 回收的实体签名置空，下标被复用时即为新实体的默认签名
+    m_signatures[ GetEntityIndex(entity) ].reset();
+    // 回收 ID，实体 ID 的代数随之更新
+    m_eid_pool.Free(entity);
+}
+
+template<typename... Comps>
+void StaticWorld<Comps...>::DestroySubtree(Entity root)
+{
+    std::vector<Entity> subtree = m_hierarchy_mngr.GetSubtree(root);
+    for (auto iter = subtree.rbegin(); iter != subtree.rend(); iter++)
+    {
+        DestroyEntity(*iter);
+    }
+}
+
+template<typename... Comps>
+void StaticWorld<Comps...>::SetParent(Entity child, Entity parent)
+{
+    assert(IsAlive(child) && (parent == INVALID_ENTITY || IsAlive(parent)) &&
+        "Entity does not exist");
+
+    m_hierarchy_mngr.SetParent(child, parent);
+}
+
+template<typename... Comps>
+void StaticWorld<Comps...>::SetParents(const std::vector<std::pair<Entity, Entity> >& child_parent_pairs)
+{
+    for (const auto& pair : child_parent_pairs)
+    {
+        assert(IsAlive(pair.first) && (pair.second == INVALID_ENTITY || IsAlive(pair.second)) &&
+            "Entity does not exist");
+    }
+
+    m_hierarchy_mngr.SetParents(child_parent_pairs);
+}
+
+template<typename... Comps>
+Entity StaticWorld<Comps...>::GetParent(Entity entity) const
+{
+    return m_hierarchy_mngr.GetParent(entity);
+}
+
+template<typename... Comps>
+Signature StaticWorld<Comps...>::GetEntitySignature(Entity entity)
+{
+    if (!m_eid_pool.IsAlive(entity))
+    {
+        return Signature();
+    }
+
+    return m_signatures[ GetEntityIndex(entity) ];
+}
+
+template<typename... Comps>
+std::set<EntityId> StaticWorld<Comps...>::GetEntities(Signature signature)
+{
+    // 与 World 一致，返回签名完全相同的实体
+    std::set<EntityId> entities;
+    for (EntityId index = 0; index < MAX_ENTITY_NUM; index++)
+    {
+        EntityId eid = m_eid_pool.GetEntityAt(index);
+        // 预留而尚未注册的实体不属于任何签名
+        if (m_eid_pool.IsAlive(eid) && m_signatures[ index ] == signature)
+        {
+            entities.insert(eid);
+        }
+    }
+
+    return entities;
+}
+
+template<typename... Comps>
+template<typename T>
+T& StaticWorld<Comps...>::AtachComp(Entity entity, T comp)
+{
+    assert(m_eid_pool.IsAlive(entity) && "Entity does not exist");
+
+    constexpr CTID current_CTID = GetCompTypeId<T>();
+    StaticCompContainer<T>& container = GetContainer<T>();
+    Signature& signature = m_signatures[ GetEntityIndex(entity) ];
+
+    // 如果实体已经拥有了该组件，直接返回已有组件
+    if (signature[ current_CTID ])
+    {
+        return container.GetComp(entity);
+    }
+
+    container.AddComp(entity, std::move(comp));
+    signature[ current_CTID ] = true;
+    // 实体签名变更，更新系统订阅的实体集合
+    UpdateSystemEntities(entity, signature);
+
+    return container.GetComp(entity);
+}
+
+template<typename... Comps>
+template<typename T>
+void StaticWorld<Comps...>::DeAtachComp(Entity entity)
+{
+    assert(m_eid_pool.IsAlive(entity) && "Entity does not exist");
+
+    constexpr CTID current_CTID = GetCompTypeId<T>();
+    Signature& signature = m_signatures[ GetEntityIndex(entity) ];
+
+    // 如果实体尚未拥有该组件，不执行任何操作
+    if (!signature[ current_CTID ])
+    {
+        return ;
+    }
+
+    GetContainer<T>().RemoveComp(entity);
+    signature[ current_CTID ] = false;
+    UpdateSystemEntities(entity, signature);
+}
+
+template<typename... Comps>
+template<typename T>
+T& StaticWorld<Comps...>::GetComp(Entity entity)
+{
+    assert(m_eid_pool.IsAlive(entity) && "Entity does not exist");
+
+    return GetContainer<T>().GetComp(entity);
+}
+
+template<typename... Comps>
+template<typename T>
+const T& StaticWorld<Comps...>::ReadComp(Entity entity)
+{
+    return GetComp<T>(entity);
+}
+
+template<typename... Comps>
+template<typename T>
+bool StaticWorld<Comps...>::HaveComp(Entity entity)
+{
+    // 组件容器只以实体下标索引，需要排除过期的实体 ID
+    return m_eid_pool.IsAlive(entity) && GetContainer<T>().HaveComp(entity);
+}
+
+template<typename... Comps>
+template<typename T, typename F>
+void StaticWorld<Comps...>::PropagateHierarchy(F func)
+{
+    StaticCompContainer<T>& container = GetContainer<T>();
+    std::size_t level_num = m_hierarchy_mngr.GetLevelNum();
+    for (std::size_t depth = 1; depth < level_num; depth++)
+    {
+        for (Entity child : m_hierarchy_mngr.GetLevel(depth))
+        {
+            Entity parent = m_hierarchy_mngr.GetParent(child);
+            if (container.HaveComp(parent) && container.HaveComp(child))
+            {
+                func(static_cast<const T&>(container.GetComp(parent)), container.GetComp(child));
+            }
+        }
+    }
+}
+
+template<typename... Comps>
+template<typename... Cs, typename F>
+void StaticWorld<Comps...>::Each(F func)
+{
+    static_assert(sizeof...(Cs) > 0, "Each requires at least one component type!");
+
+    // 从组件数量最少的容器开始遍历
+    std::array<Span<EntityId>, sizeof...(Cs)> pools{ { GetContainer<Cs>().GetEntities()... } };
+    Span<EntityId> smallest = *std::min_element(pools.begin(), pools.end(),
+        [](const Span<EntityId>& a, const Span<EntityId>& b) { return a.size < b.size; });
+
+    for (EntityId eid : smallest)
+    {
+        if ((GetContainer<Cs>().HaveComp(eid) && ...))
+        {
+            func(eid, GetContainer<Cs>().GetComp(eid)...);
+        }
+    }
+}
+
+template<typename... Comps>
+template<typename T>
+void StaticWorld<Comps...>::RegisterSys(Signature signature)
+{
+    // 若当前类不是继承自 System 则报错
+    static_assert(
+        std::is_base_of<System, T>::value,
+        "This class does not inherit from StaticWorld::System!"
+    );
+
+    const char* type_name = typeid(T).name();
+    for (auto& entry : m_systems)
+    {
+        if (entry.type_name == type_name)
+        {
+            return ;
+        }
+    }
+
+    std::shared_ptr<System> system = std::make_shared<T>();
+    system->world = this;
+    // 注册系统之后更新系统关注的实体
+    for (EntityId index = 0; index < MAX_ENTITY_NUM; index++)
+    {
+        EntityId eid = m_eid_pool.GetEntityAt(index);
+        if (m_eid_pool.IsAlive(eid) && (m_signatures[ index ] & signature) == signature)
+        {
+            system->entities.insert(eid);
+        }
+    }
+    m_systems.push_back({type_name, signature, std::move(system)});
+}
+
+template<typename... Comps>
+template<typename T, typename... Cs>
+void StaticWorld<Comps...>::RegisterSys()
+{
+    constexpr Signature signature = GetSignature<Cs...>();
+    RegisterSys<T>(signature);
+}
+
+template<typename... Comps>
+template<typename T>
+T& StaticWorld<Comps...>::GetSys()
+{
+    const char* type_name = typeid(T).name();
+    auto iter = std::find_if(m_systems.begin(), m_systems.end(),
+        [type_name](const SystemEntry& entry) { return entry.type_name == type_name; });
+    assert(iter != m_systems.end() && "This system has not been registered!");
+
+    return *static_cast<T*>(iter->system.get());
+}
+
+template<typename... Comps>
+void StaticWorld<Comps...>::Update(float dt)
+{
+    for (auto& entry : m_systems)
+    {
+        entry.system->OnUpdate(dt);
+    }
+    m_event_mngr.Swap();
+}
+
+template<typename... Comps>
+template<typename E>
+void StaticWorld<Comps...>::RegisterEvent()
+{
+    m_event_mngr.Register<E>();
+}
+
+template<typename... Comps>
+template<typename E, typename... Args>
+void StaticWorld<Comps...>::Emit(Args&&... args)
+{
+    m_event_mngr.Emit<E>(std::forward<Args>(args)...);
+}
+
+template<typename... Comps>
+template<typename E>
+EventView<E> StaticWorld<Comps...>::ReadEvents()
+{
+    return m_event_mngr.Read<E>();
+}
+
+template<typename... Comps>
+void StaticWorld<Comps...>::UpdateSystemEntities(Entity entity, Signature signature)
+{
+    for (auto& entry : m_systems)
+    {
+        if ((signature & entry.signature) == entry.signature)
+        {
+            entry.system->entities.insert(entity);
+        }
+        else
+        {
+            entry.system->entities.erase(entity);
+        }
+    }
+}
+
+template<typename... Comps>
+template<typename T>
+StaticCompContainer<T>& StaticWorld<Comps...>::GetContainer()
+{
+    return std::get<GetCompTypeId<T>()>(*m_containers);
+}
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <memory>
+#include <functional>
 #include "ECS/EntityMngr.h"
+#include "ECS/Prefab.h"
 #include "ECS/SystemMngr.h"
+#include "ECS/EventMngr.h"
+#include "ECS/HierarchyMngr.h"
 
 /* 
   世界类
@@ -20,11 +24,81 @@ public:
     */ 
     Entity CreateEntity();
 
+    /* 
+      预留一个实体
+      线程安全，可以在并行执行的系统中调用
+      预留的实体在调用 FlushReservedEntities 之后才能添加组件
+      在此之前 IsAlive 返回 false，也无法被销毁
+    */ 
+    Entity ReserveEntity();
+
+    /* 
+      注册所有预留的实体
+      只允许在主线程调用，例如在两次 Update 之间
+    */ 
+    void FlushReservedEntities();
+
+    /* 
+      判断实体是否存活
+      已销毁实体的 ID 即使被复用也会返回 false
+    */ 
+    bool IsAlive(Entity entity) const;
+
+    /* 
+      由预制体批量创建实体
+      组件值批量复制，所有实体一次性加入关注它们的系统
+      \param prefab      预制体
+      \param n           创建的实体数量
+      \param on_instance 可选，形如 void(Entity entity, std::size_t i) 的函数
+                          在实体加入系统后对每个实体调用，用来修改组件的值或增删组件
+      \return            被创建的实体
+    */ 
+    std::vector<Entity> Instantiate(const Prefab& prefab, std::size_t n,
+        const std::function<void(Entity, std::size_t)>& on_instance = nullptr);
+
+    /* 
+      由一组预制体批量创建实体，每个预制体创建一个实体
+      组件类型相同的预制体分为一批，每批只查找一次组件容器，并一次性加入关注它们的系统
+      \param prefabs 预制体，组件类型可以各不相同
+      \return        被创建的实体，与 prefabs 一一对应
+    */ 
+    std::vector<Entity> InstantiateEach(const std::vector<const Prefab*>& prefabs);
+
+    /* 
+      将实体的所有组件复制到一个预制体中
+      可以由此预制体在其他世界中创建相同的实体
+    */ 
+    Prefab ExportEntity(Entity entity);
+
     /* 
       销毁一个实体
     */ 
     void DestroyEntity(Entity entity);
 
+    /* 
+      销毁一个实体及其所有后代实体
+      时间复杂度与子树大小成正比
+    */ 
+    void DestroySubtree(Entity root);
+
+    /* 
+      设置实体的父实体
+      \param parent 父实体，为 INVALID_ENTITY 时使实体脱离其父实体
+    */ 
+    void SetParent(Entity child, Entity parent);
+
+    /* 
+      批量设置实体的父实体
+      \param child_parent_pairs [ 子实体 | 父实体 ] 列表
+    */ 
+    void SetParents(const std::vector<std::pair<Entity, Entity> >& child_parent_pairs);
+
+    /* 
+      获取实体的父实体
+      \return 父实体，没有父实体时返回 INVALID_ENTITY
+    */ 
+    Entity GetParent(Entity entity) const;
+
     /* 
       获取一个实体的签名
     */ 
@@ -52,10 +126,20 @@ public:
     /* 
       模板函数
       获取到实体的组件
+      返回的组件可以修改，双缓冲组件会因此被标记为已修改
     */ 
     template<typename T>
     T& GetComp(Entity entity);
 
+    /* 
+      模板函数
+      只读获取实体的组件
+      不会将双缓冲组件标记为已修改，只读访问时应优先使用
+      没有线程修改世界时可以在多个线程中同时调用
+    */ 
+    template<typename T>
+    const T& ReadComp(Entity entity);
+
     /* 
       模板函数
       查询一个实体是否拥有组件
@@ -63,17 +147,103 @@ public:
     template<typename T>
     bool HaveComp(Entity entity);
 
+    /* 
+      模板函数
+      指定类型的组件改为存储在内存映射文件中
+      适用于组件总量超过物理内存的世界，访问组件的方式不变
+      实体数量仍受 MAX_ENTITY_NUM 限制，其上限为 ENTITY_INDEX_MASK，约一百万
+      需要在第一次添加该类型组件之前调用
+      \param path      映射文件的路径，文件仅作为换页空间，世界销毁时删除
+      \param residency 组件的驻留方式
+    */ 
+    template<typename T>
+    void UseMappedStorage(const std::string& path, CompResidency residency = CompResidency::HOT);
+
+    /* 
+      模板函数
+      修改存储在映射文件中的组件的驻留方式
+    */ 
+    template<typename T>
+    void SetCompResidency(CompResidency residency);
+
+    /* 
+      将所有驻留方式为 COLD 的组件换出内存
+      可以在访问完不常用的组件后调用
+    */ 
+    void TrimColdComps();
+
+    /* 
+      模板函数
+      指定类型的组件改为双缓冲存储
+      系统通过 GetComp 读写后台缓冲，每次 Update 结束时被修改的组件复制到前台缓冲
+      需要在第一次添加该类型组件之前调用
+      \return 双缓冲组件容器，其他线程可通过 ReadFront 只读访问上一帧的组件
+    */ 
+    template<typename T>
+    std::shared_ptr<DoubleBufferedCompContainer<T> > UseDoubleBuffer();
+
+    /* 
+      模板函数
+      沿层级由父到子传递组件数据，例如计算世界变换
+      按深度逐层遍历，父实体的组件总是先于子实体被处理
+      父子实体均拥有 T 类型组件时才会调用 func
+      \param func 形如 void(const T& parent, T& child) 的函数
+    */ 
+    template<typename T, typename F>
+    void PropagateHierarchy(F func);
+
     /* 
       模板函数
       注册一个系统
       \param signature 系统关注的实体签名
+      \param schedule  系统的调度方式，包括更新阶段、执行间隔与时间分片
+    */ 
+    template<typename T>
+    void RegisterSys(Signature signature, SystemSchedule schedule = SystemSchedule());
+
+    /* 
+      设置 FIXED_UPDATE 阶段的固定时间步长
+      \param step      固定时间步长
+      \param max_steps 每帧最多执行的固定步数
+    */ 
+    void SetFixedTimeStep(float step, unsigned int max_steps = 8);
+
+    /* 
+      模板函数
+      获取一个已注册的系统
     */ 
     template<typename T>
-    void RegisterSys(Signature signature);
+    T& GetSys();
+
+    /* 
+      模板函数
+      注册一种事件类型
+      需要在发送该类型事件之前调用
+    */ 
+    template<typename E>
+    void RegisterEvent();
+
+    /* 
+      模板函数
+      发送一个事件
+      线程安全，事件在下一帧才能被读取
+      \param args 构造事件的参数
+    */ 
+    template<typename E, typename... Args>
+    void Emit(Args&&... args);
+
+    /* 
+      模板函数
+      读取上一帧发送的指定类型事件
+    */ 
+    template<typename E>
+    EventView<E> ReadEvents();
 
     /* 
       更新一帧
       调用系统管理器的更新方法
+      之后交换事件缓冲，本帧发送的事件在下一帧可读
+      最后交换双缓冲组件的前后台缓冲
       \param dt 当前帧与上一帧的间隔时间
     */ 
     void Update(float dt);
@@ -81,6 +251,8 @@ public:
 private:
     std::unique_ptr<EntityMngr> m_entity_mngr;
     std::unique_ptr<SystemMngr> m_system_mngr;
+    std::unique_ptr<EventMngr> m_event_mngr;
+    std::unique_ptr<HierarchyMngr> m_hierarchy_mngr;
 };
 
 template<class T> 
@@ -109,6 +281,12 @@ T& World::GetComp(Entity entity)
     return m_entity_mngr->GetComp<T>(entity);
 }
 
+template<class T>
+const T& World::ReadComp(Entity entity)
+{
+    return m_entity_mngr->ReadComp<T>(entity);
+}
+
 template<class T>
 bool World::HaveComp(Entity entity)
 {
@@ -116,9 +294,77 @@ bool World::HaveComp(Entity entity)
 }
 
 template<class T>
-void World::RegisterSys(Signature signature)
+void World::UseMappedStorage(const std::string& path, CompResidency residency)
 {
-    m_system_mngr->Register<T>(signature, this);
+    m_entity_mngr->UseMappedStorage<T>(path, residency);
+}
+
+template<class T>
+void World::SetCompResidency(CompResidency residency)
+{
+    m_entity_mngr->SetCompResidency<T>(residency);
+}
+
+template<class T>
+std::shared_ptr<DoubleBufferedCompContainer<T> > World::UseDoubleBuffer()
+{
+    return m_entity_mngr->UseDoubleBuffer<T>();
+}
+
+template<class T, class F>
+void World::PropagateHierarchy(F func)
+{
+    // 组件存储只查找一次，遍历时直接访问
+    // 层级中只有存活的实体，不需要再经过实体管理器检查
+    ICompStorage<T>* storage = m_entity_mngr->GetStorage<T>();
+    if (storage == nullptr)
+    {
+        return ;
+    }
+
+    std::size_t level_num = m_hierarchy_mngr->GetLevelNum();
+    // 根实体没有父实体，从深度 1 开始
+    for (std::size_t depth = 1; depth < level_num; depth++)
+    {
+        for (Entity child : m_hierarchy_mngr->GetLevel(depth))
+        {
+            Entity parent = m_hierarchy_mngr->GetParent(child);
+            if (storage->HaveComp(parent) && storage->HaveComp(child))
+            {
+                func(storage->ReadComp(parent), storage->GetComp(child));
+            }
+        }
+    }
+}
+
+template<class T>
+void World::RegisterSys(Signature signature, SystemSchedule schedule)
+{
+    m_system_mngr->Register<T>(signature, this, schedule);
     // 注册系统之后更新系统关注的实体
     m_system_mngr->SetEntities<T>(m_entity_mngr->GetEntities(signature));
 }
+
+template<class T>
+T& World::GetSys()
+{
+    return m_system_mngr->GetSystem<T>();
+}
+
+template<class E>
+void World::RegisterEvent()
+{
+    m_event_mngr->Register<E>();
+}
+
+template<class E, class... Args>
+void World::Emit(Args&&... args)
+{
+    m_event_mngr->Emit<E>(std::forward<Args>(args)...);
+}
+
+template<class E>
+EventView<E> World::ReadEvents()
+{
+    return m_event_mngr->Read<E>();
+}
@@ -0,0 +1,23 @@
+#include "ECS/Barrier.h"
+
+Barrier::Barrier(std::size_t count)
+    : m_count(count), m_arrived(0), m_generation(0)
+{
+}
+
+void Barrier::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    std::size_t generation = m_generation;
+    m_arrived += 1;
+    // 最后到达的线程唤醒其他线程
+    if (m_arrived == m_count)
+    {
+        m_arrived = 0;
+        m_generation += 1;
+        m_cond.notify_all();
+        return ;
+    }
+
+    m_cond.wait(lock, [this, generation] { return generation != m_generation; });
+}
@@ -0,0 +1,143 @@
+#include "ECS/EntityIdPool.h"
+
+EntityIdPool::EntityIdPool()
+    : m_free_head(NIL_INDEX), m_reserved_head(NIL_INDEX)
+{
+    for (EntityId index = 0; index < MAX_ENTITY_NUM; index++)
+    {
+        m_versions[ index ].store(0, std::memory_order_relaxed);
+        m_reserved[ index ].store(false, std::memory_order_relaxed);
+    }
+    // 逆序压入，保证最先分配到的是下标 0
+    for (EntityId index = MAX_ENTITY_NUM; index > 0; index--)
+    {
+        Push(m_free_head, index - 1);
+    }
+}
+
+EntityId EntityIdPool::Allocate()
+{
+    EntityId index = Pop(m_free_head);
+    if (index == NIL_INDEX)
+    {
+        return INVALID_ENTITY;
+    }
+    // 版本号变为奇数，标记为存活
+    unsigned int version = m_versions[ index ].fetch_add(1, std::memory_order_acq_rel) + 1;
+
+    return MakeEntityId(index, version >> 1);
+}
+
+bool EntityIdPool::Free(EntityId eid)
+{
+    EntityId index = GetEntityIndex(eid);
+    if (index >= MAX_ENTITY_NUM)
+    {
+        return false;
+    }
+
+    // 只有代数匹配且存活时才允许回收，防止重复回收
+    unsigned int version = m_versions[ index ].load(std::memory_order_acquire);
+    do
+    {
+        if ((version & 1) == 0 ||
+            ((version >> 1) & ENTITY_GENERATION_MASK) != GetEntityGeneration(eid))
+        {
+            return false;
+        }
+    } while (!m_versions[ index ].compare_exchange_weak(
+        version, version + 1, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    Push(m_free_head, index);
+
+    return true;
+}
+
+EntityId EntityIdPool::Reserve()
+{
+    EntityId eid = Allocate();
+    if (eid != INVALID_ENTITY)
+    {
+        m_reserved[ GetEntityIndex(eid) ].store(true, std::memory_order_release);
+        Push(m_reserved_head, GetEntityIndex(eid));
+    }
+
+    return eid;
+}
+
+std::vector<EntityId> EntityIdPool::TakeReserved()
+{
+    std::vector<EntityId> reserved;
+    // 一次性取走整个预留栈
+    StackHead head = m_reserved_head.exchange(NIL_INDEX, std::memory_order_acq_rel);
+    EntityId index = static_cast<EntityId>(head);
+    while (index != NIL_INDEX)
+    {
+        reserved.push_back(GetEntityAt(index));
+        EntityId next = m_next[ index ].load(std::memory_order_relaxed);
+        // 取出后视为存活
+        m_reserved[ index ].store(false, std::memory_order_release);
+        index = next;
+    }
+
+    return reserved;
+}
+
+bool EntityIdPool::IsAlive(EntityId eid) const
+{
+    EntityId index = GetEntityIndex(eid);
+    if (index >= MAX_ENTITY_NUM)
+    {
+        return false;
+    }
+
+    unsigned int version = m_versions[ index ].load(std::memory_order_acquire);
+
+    return (version & 1) == 1 &&
+        ((version >> 1) & ENTITY_GENERATION_MASK) == GetEntityGeneration(eid) &&
+        !m_reserved[ index ].load(std::memory_order_acquire);
+}
+
+EntityId EntityIdPool::GetEntityAt(EntityId index) const
+{
+    unsigned int version = m_versions[ index ].load(std::memory_order_acquire);
+    if ((version & 1) == 0)
+    {
+        return INVALID_ENTITY;
+    }
+
+    return MakeEntityId(index, version >> 1);
+}
+
+void EntityIdPool::Push(std::atomic<StackHead>& head, EntityId index)
+{
+    StackHead old_head = head.load(std::memory_order_relaxed);
+    StackHead new_head;
+    do
+    {
+        m_next[ index ].store(static_cast<EntityId>(old_head), std::memory_order_relaxed);
+        // 每次修改栈顶时标记加一
+        new_head = (((old_head >> 32) + 1) << 32) | index;
+    } while (!head.compare_exchange_weak(
+        old_head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+EntityId EntityIdPool::Pop(std::atomic<StackHead>& head)
+{
+    StackHead old_head = head.load(std::memory_order_acquire);
+    StackHead new_head;
+    EntityId index;
+    do
+    {
+        index = static_cast<EntityId>(old_head);
+        if (index == NIL_INDEX)
+        {
+            return NIL_INDEX;
+        }
+        EntityId next = m_next[ index ].load(std::memory_order_relaxed);
+        new_head = (((old_head >> 32) + 1) << 32) | next;
+    } while (!head.compare_exchange_weak(
+        old_head, new_head, std::memory_order_acq_rel, std::memory_order_acquire));
+
+    return index;
+}
@@ -1,23 +1,52 @@
+#include <atomic>
 #include "ECS/EntityMngr.h"
+#include "ECS/Prefab.h"
 
 
 EntityMngr::EntityMngr()
 {
     m_entity_num = 0;
-    // 初始化可用的实体 ID
-    for (EntityId eid = 0; eid < MAX_ENTITY_NUM; eid++)
-    {
-        m_available_eids.push(eid);
-    }
 }
 
 EntityId EntityMngr::CreateEntity()
 {
     // 取出一个当前可用的实体 ID
-    EntityId eid = m_available_eids.front();
-    m_available_eids.pop();
-    // 实体默认签名为空
-    Signature signature;
+    EntityId eid = m_eid_pool.Allocate();
+    assert(eid != INVALID_ENTITY &&
+        "The number of entities has reached the maximum!");
+
+    RegisterEntity(eid);
+
+    return eid;
+}
+
+EntityId EntityMngr::ReserveEntity()
+{
+    EntityId eid = m_eid_pool.Reserve();
+    assert(eid != INVALID_ENTITY &&
+        "The number of entities has reached the maximum!");
+
+    return eid;
+}
+
+std::vector<EntityId> EntityMngr::FlushReservedEntities()
+{
+    std::vector<EntityId> reserved = m_eid_pool.TakeReserved();
+    for (EntityId eid : reserved)
+    {
+        RegisterEntity(eid);
+    }
+
+    return reserved;
+}
+
+bool EntityMngr::IsAlive(EntityId eid) const
+{
+    return m_eid_pool.IsAlive(eid);
+}
+
+void EntityMngr::RegisterEntity(EntityId eid, Signature signature)
+{
     unsigned long sig_long = signature.to_ulong();
     // 更新实体与签名的索引信息
     m_eid_to_signature.insert({eid, std::move(signature)});
@@ -30,8 +59,91 @@ EntityId EntityMngr::CreateEntity()
     m_signature_to_eids[ sig_long ].insert(eid);
     // 更新实体数量
     m_entity_num += 1;
+}
 
-    return eid;
+std::vector<EntityId> EntityMngr::Instantiate(const Prefab& prefab, std::size_t n)
+{
+    // 每种组件只查找一次类型 ID 与容器
+    std::vector<std::pair<ICompContainer*, const void*> > targets;
+    Signature signature;
+    for (const Prefab::CompRecord& record : prefab.m_records)
+    {
+        CTID comp_type_Id;
+        ICompContainer* comp_container = record.resolve(*this, comp_type_Id);
+        signature[ comp_type_Id ] = true;
+        targets.push_back({comp_container, prefab.GetCompData(record)});
+    }
+
+    std::vector<EntityId> eids;
+    eids.reserve(n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        EntityId eid = m_eid_pool.Allocate();
+        assert(eid != INVALID_ENTITY &&
+            "The number of entities has reached the maximum!");
+        // 实体直接以预制体的签名注册
+        RegisterEntity(eid, signature);
+        eids.push_back(eid);
+    }
+
+    for (auto& target : targets)
+    {
+        target.first->AddComps(eids.data(), n, target.second);
+    }
+
+    return eids;
+}
+
+std::vector<EntityId> EntityMngr::InstantiateEach(const std::vector<const Prefab*>& prefabs)
+{
+    std::vector<EntityId> eids;
+    if (prefabs.empty())
+    {
+        return eids;
+    }
+
+    // 所有预制体的组件类型相同，按第一个预制体查找类型 ID 与容器
+    const Prefab& first = *prefabs.front();
+    std::vector<ICompContainer*> containers;
+    Signature signature;
+    for (const Prefab::CompRecord& record : first.m_records)
+    {
+        CTID comp_type_Id;
+        containers.push_back(record.resolve(*this, comp_type_Id));
+        signature[ comp_type_Id ] = true;
+    }
+
+    eids.reserve(prefabs.size());
+    for (const Prefab* prefab : prefabs)
+    {
+        assert(prefab->SameCompTypes(first) &&
+            "Prefabs instantiated together must have the same component types!");
+        EntityId eid = m_eid_pool.Allocate();
+        assert(eid != INVALID_ENTITY &&
+            "The number of entities has reached the maximum!");
+        RegisterEntity(eid, signature);
+        eids.push_back(eid);
+    }
+
+    // 逐个容器写入，每个实体的组件值来自各自的预制体
+    for (std::size_t c = 0; c < containers.size(); c++)
+    {
+        for (std::size_t i = 0; i < prefabs.size(); i++)
+        {
+            const Prefab& prefab = *prefabs[ i ];
+            containers[ c ]->AddComps(&eids[ i ], 1, prefab.GetCompData(prefab.m_records[ c ]));
+        }
+    }
+
+    return eids;
+}
+
+void EntityMngr::ExportEntity(EntityId eid, Prefab& prefab)
+{
+    for (auto& pair : m_type_to_comp_container)
+    {
+        pair.second->ExportComp(eid, prefab);
+    }
 }
 
 void EntityMngr::DestroyEntity(EntityId eid)
@@ -49,13 +161,29 @@ void EntityMngr::DestroyEntity(EntityId eid)
             iter->second->RemoveComp(eid);
             iter++;
         }
-        // 回收 ID
-        m_available_eids.push(eid);
+        // 回收 ID，实体 ID 的代数随之更新
+        m_eid_pool.Free(eid);
         // 更新实体数量
         m_entity_num -= 1;
     }
 }
 
+void EntityMngr::TrimColdComps()
+{
+    for (auto& pair : m_type_to_comp_container)
+    {
+        pair.second->TrimCold();
+    }
+}
+
+void EntityMngr::SwapCompBuffers()
+{
+    for (auto& pair : m_type_to_comp_container)
+    {
+        pair.second->SwapBuffers();
+    }
+}
+
 std::set<EntityId> EntityMngr::GetEntities(Signature sig)
 {
     unsigned long sig_long = sig.to_ulong();
@@ -79,12 +207,14 @@ Signature EntityMngr::GetSignature(EntityId eid)
 
 CTID EntityMngr::GetUniqueCTID()
 {
-    static CTID unique_Id = 0;
+    // 多个世界可能在不同线程中同时注册组件类型
+    static std::atomic<CTID> unique_Id(0);
+    CTID comp_type_Id = unique_Id.fetch_add(1, std::memory_order_relaxed);
     // 如果组件类型数量达到最大值，进行报警
-    assert(unique_Id < MAX_COMP_TYPE_NUM &&
+    assert(comp_type_Id < MAX_COMP_TYPE_NUM &&
         "The number of component types has reached the maximum!");
 
-    return unique_Id++;
+    return comp_type_Id;
 }
 
 void EntityMngr::UpdateSignature(EntityId eid, CTID changed_comp_type_Id, bool changed_type)
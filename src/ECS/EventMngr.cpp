@@ -0,0 +1,86 @@
+#include <mutex>
+#include <vector>
+#include "ECS/EventMngr.h"
+
+void EventMngr::Swap()
+{
+    for (auto& pair : m_type_to_queue)
+    {
+        pair.second->Swap();
+    }
+}
+
+namespace
+{
+
+/*
+  线程缓冲下标的分配记录
+  所有事件管理器共用
+*/
+class ThreadSlotPool
+{
+public:
+    ThreadSlotPool()
+    {
+        // 逆序压入，保证最先分配到的是下标 0
+        for (std::size_t slot = MAX_EVENT_THREAD_NUM; slot > 0; slot--)
+        {
+            m_free_slots.push_back(slot - 1);
+        }
+    }
+
+    std::size_t Acquire()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_free_slots.empty())
+        {
+            return SHARED_EVENT_SLOT;
+        }
+        std::size_t slot = m_free_slots.back();
+        m_free_slots.pop_back();
+
+        return slot;
+    }
+
+    void Release(std::size_t slot)
+    {
+        if (slot == SHARED_EVENT_SLOT)
+        {
+            return ;
+        }
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_free_slots.push_back(slot);
+    }
+
+private:
+    std::mutex m_mutex;
+    // 未被占用的下标
+    std::vector<std::size_t> m_free_slots;
+};
+
+ThreadSlotPool& GetThreadSlotPool()
+{
+    static ThreadSlotPool pool;
+    return pool;
+}
+
+/*
+  线程持有的缓冲下标
+  线程退出时归还下标，缓冲中尚未交换的事件保留到下一次交换
+*/
+struct ThreadSlot
+{
+    ThreadSlot() : slot(GetThreadSlotPool().Acquire()) {}
+    ~ThreadSlot() { GetThreadSlotPool().Release(slot); }
+
+    std::size_t slot;
+};
+
+}
+
+std::size_t EventMngr::GetThreadSlot()
+{
+    thread_local const ThreadSlot thread_slot;
+
+    return thread_slot.slot;
+}
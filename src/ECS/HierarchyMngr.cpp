@@ -0,0 +1,239 @@
+#include <cassert>
+#include "ECS/HierarchyMngr.h"
+
+HierarchyMngr::HierarchyMngr()
+    : m_nodes(MAX_ENTITY_NUM,
+        Node{INVALID_ENTITY, INVALID_ENTITY, INVALID_ENTITY, INVALID_ENTITY, INVALID_ENTITY, 0}),
+      m_order_dirty(true)
+{
+}
+
+void HierarchyMngr::SetParent(Entity child, Entity parent)
+{
+    assert(child != parent && "An entity can not be its own parent!");
+
+    if (Contains(child))
+    {
+        Unlink(child);
+    }
+    if (parent == INVALID_ENTITY)
+    {
+        LeaveIfIsolated(child);
+        m_order_dirty = true;
+        return ;
+    }
+
+    // 父实体不能是子实体的后代，否则会形成环
+    for (Entity ancestor = parent; ancestor != INVALID_ENTITY; ancestor = GetParent(ancestor))
+    {
+        assert(ancestor != child && "Setting this parent would create a cycle!");
+    }
+
+    if (!Contains(child))
+    {
+        Join(child);
+    }
+    if (!Contains(parent))
+    {
+        Join(parent);
+    }
+
+    // 将子实体插入到父实体子链表的头部
+    Node& child_node = m_nodes[ GetEntityIndex(child) ];
+    Node& parent_node = m_nodes[ GetEntityIndex(parent) ];
+    child_node.parent = parent;
+    child_node.prev_sibling = INVALID_ENTITY;
+    child_node.next_sibling = parent_node.first_child;
+    if (parent_node.first_child != INVALID_ENTITY)
+    {
+        m_nodes[ GetEntityIndex(parent_node.first_child) ].prev_sibling = child;
+    }
+    parent_node.first_child = child;
+
+    m_order_dirty = true;
+}
+
+void HierarchyMngr::SetParents(const std::vector<std::pair<Entity, Entity> >& child_parent_pairs)
+{
+    for (const auto& pair : child_parent_pairs)
+    {
+        SetParent(pair.first, pair.second);
+    }
+}
+
+void HierarchyMngr::Remove(Entity entity)
+{
+    if (!Contains(entity))
+    {
+        return ;
+    }
+
+    Unlink(entity);
+    // 所有子实体成为根实体
+    Entity child = m_nodes[ GetEntityIndex(entity) ].first_child;
+    while (child != INVALID_ENTITY)
+    {
+        Node& child_node = m_nodes[ GetEntityIndex(child) ];
+        Entity next = child_node.next_sibling;
+        child_node.parent = INVALID_ENTITY;
+        child_node.prev_sibling = INVALID_ENTITY;
+        child_node.next_sibling = INVALID_ENTITY;
+        LeaveIfIsolated(child);
+        child = next;
+    }
+    m_nodes[ GetEntityIndex(entity) ].first_child = INVALID_ENTITY;
+    LeaveIfIsolated(entity);
+
+    m_order_dirty = true;
+}
+
+Entity HierarchyMngr::GetParent(Entity entity) const
+{
+    return Contains(entity) ? m_nodes[ GetEntityIndex(entity) ].parent : INVALID_ENTITY;
+}
+
+Entity HierarchyMngr::GetFirstChild(Entity entity) const
+{
+    return Contains(entity) ? m_nodes[ GetEntityIndex(entity) ].first_child : INVALID_ENTITY;
+}
+
+Entity HierarchyMngr::GetNextSibling(Entity entity) const
+{
+    return Contains(entity) ? m_nodes[ GetEntityIndex(entity) ].next_sibling : INVALID_ENTITY;
+}
+
+std::vector<Entity> HierarchyMngr::GetSubtree(Entity root) const
+{
+    std::vector<Entity> subtree = {root};
+    // 逐个展开已收集实体的子实体
+    for (std::size_t i = 0; i < subtree.size(); i++)
+    {
+        for (Entity child = GetFirstChild(subtree[ i ]);
+            child != INVALID_ENTITY;
+            child = m_nodes[ GetEntityIndex(child) ].next_sibling)
+        {
+            subtree.push_back(child);
+        }
+    }
+
+    return subtree;
+}
+
+std::size_t HierarchyMngr::GetLevelNum()
+{
+    if (m_order_dirty)
+    {
+        RebuildOrder();
+    }
+
+    return m_level_offsets.size() - 1;
+}
+
+Span<Entity> HierarchyMngr::GetLevel(std::size_t depth)
+{
+    if (m_order_dirty)
+    {
+        RebuildOrder();
+    }
+    assert(depth + 1 < m_level_offsets.size() && "The depth exceeds the hierarchy!");
+
+    std::size_t begin = m_level_offsets[ depth ];
+    return Span<Entity>{m_order.data() + begin, m_level_offsets[ depth + 1 ] - begin};
+}
+
+bool HierarchyMngr::Contains(Entity entity) const
+{
+    return entity != INVALID_ENTITY && m_nodes[ GetEntityIndex(entity) ].entity == entity;
+}
+
+void HierarchyMngr::Join(Entity entity)
+{
+    Node& node = m_nodes[ GetEntityIndex(entity) ];
+    node = Node{entity, INVALID_ENTITY, INVALID_ENTITY, INVALID_ENTITY, INVALID_ENTITY, m_members.size()};
+    m_members.push_back(entity);
+}
+
+void HierarchyMngr::LeaveIfIsolated(Entity entity)
+{
+    if (!Contains(entity))
+    {
+        return ;
+    }
+
+    Node& node = m_nodes[ GetEntityIndex(entity) ];
+    if (node.parent != INVALID_ENTITY || node.first_child != INVALID_ENTITY)
+    {
+        return ;
+    }
+
+    // 用最后一个成员填补空位
+    Entity last_member = m_members.back();
+    m_members[ node.member_idx ] = last_member;
+    m_nodes[ GetEntityIndex(last_member) ].member_idx = node.member_idx;
+    m_members.pop_back();
+    node.entity = INVALID_ENTITY;
+}
+
+void HierarchyMngr::Unlink(Entity child)
+{
+    Node& child_node = m_nodes[ GetEntityIndex(child) ];
+    if (child_node.parent == INVALID_ENTITY)
+    {
+        return ;
+    }
+
+    if (child_node.prev_sibling != INVALID_ENTITY)
+    {
+        m_nodes[ GetEntityIndex(child_node.prev_sibling) ].next_sibling = child_node.next_sibling;
+    }
+    else
+    {
+        m_nodes[ GetEntityIndex(child_node.parent) ].first_child = child_node.next_sibling;
+    }
+    if (child_node.next_sibling != INVALID_ENTITY)
+    {
+        m_nodes[ GetEntityIndex(child_node.next_sibling) ].prev_sibling = child_node.prev_sibling;
+    }
+
+    Entity parent = child_node.parent;
+    child_node.parent = INVALID_ENTITY;
+    child_node.prev_sibling = INVALID_ENTITY;
+    child_node.next_sibling = INVALID_ENTITY;
+    LeaveIfIsolated(parent);
+}
+
+void HierarchyMngr::RebuildOrder()
+{
+    m_order.clear();
+    m_level_offsets.clear();
+
+    // 深度 0 为所有根实体
+    m_level_offsets.push_back(0);
+    for (Entity entity : m_members)
+    {
+        if (m_nodes[ GetEntityIndex(entity) ].parent == INVALID_ENTITY)
+        {
+            m_order.push_back(entity);
+        }
+    }
+
+    // 每一层的子实体依次追加到序列末尾
+    std::size_t level_begin = 0;
+    while (level_begin < m_order.size())
+    {
+        std::size_t level_end = m_order.size();
+        m_level_offsets.push_back(level_end);
+        for (std::size_t i = level_begin; i < level_end; i++)
+        {
+            for (Entity child = m_nodes[ GetEntityIndex(m_order[ i ]) ].first_child;
+                child != INVALID_ENTITY;
+                child = m_nodes[ GetEntityIndex(child) ].next_sibling)
+            {
+                m_order.push_back(child);
+            }
+        }
+        level_begin = level_end;
+    }
+
+    m_order_dirty = false;
+}
@@ -0,0 +1,230 @@
+#include "ECS/MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : m_data(nullptr), m_size(0),
+#ifdef _WIN32
+      m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr)
+#else
+      m_fd(-1)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+std::size_t MappedFile::GetPageSize()
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    // 映射的偏移需要按分配粒度对齐，以此作为页大小
+    return info.dwAllocationGranularity;
+#else
+    return static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    // 关闭句柄时由系统删除文件
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+        CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+
+    return m_file != INVALID_HANDLE_VALUE;
+}
+
+bool MappedFile::Resize(std::size_t size)
+{
+    std::size_t page_size = GetPageSize();
+    std::size_t new_size = (size + page_size - 1) / page_size * page_size;
+    if (new_size == m_size)
+    {
+        return true;
+    }
+
+    Unmap();
+    LARGE_INTEGER file_size;
+    file_size.QuadPart = static_cast<LONGLONG>(new_size);
+    if (!SetFilePointerEx(m_file, file_size, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file))
+    {
+        return false;
+    }
+    m_size = new_size;
+
+    return Map();
+}
+
+void MappedFile::Close()
+{
+    Unmap();
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+    }
+    m_size = 0;
+}
+
+bool MappedFile::Map()
+{
+    if (m_size == 0)
+    {
+        return true;
+    }
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<unsigned long long>(m_size) >> 32),
+        static_cast<DWORD>(m_size), nullptr);
+    if (m_mapping == nullptr)
+    {
+        return false;
+    }
+    m_data = MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, m_size);
+
+    return m_data != nullptr;
+}
+
+void MappedFile::Unmap()
+{
+    if (m_data != nullptr)
+    {
+        UnmapViewOfFile(m_data);
+        m_data = nullptr;
+    }
+    if (m_mapping != nullptr)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+    }
+}
+
+// Windows 下没有与 madvise 对应的顺序访问与预读提示
+void MappedFile::AdviseSequential() {}
+
+void MappedFile::AdviseWillNeed() {}
+
+void MappedFile::AdvisePageOut()
+{
+    if (m_data != nullptr)
+    {
+        // 对未锁定的页调用 VirtualUnlock 会将其移出工作集
+        VirtualUnlock(m_data, m_size);
+    }
+}
+
+#else
+
+bool MappedFile::Open(const std::string& path)
+{
+    Close();
+    m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (m_fd < 0)
+    {
+        return false;
+    }
+    // 文件在描述符关闭前仍然可用
+    unlink(path.c_str());
+
+    return true;
+}
+
+bool MappedFile::Resize(std::size_t size)
+{
+    std::size_t page_size = GetPageSize();
+    std::size_t new_size = (size + page_size - 1) / page_size * page_size;
+    if (new_size == m_size)
+    {
+        return true;
+    }
+
+    Unmap();
+    if (ftruncate(m_fd, static_cast<off_t>(new_size)) != 0)
+    {
+        return false;
+    }
+    m_size = new_size;
+
+    return Map();
+}
+
+void MappedFile::Close()
+{
+    Unmap();
+    if (m_fd >= 0)
+    {
+        close(m_fd);
+        m_fd = -1;
+    }
+    m_size = 0;
+}
+
+bool MappedFile::Map()
+{
+    if (m_size == 0)
+    {
+        return true;
+    }
+
+    void* data = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+    m_data = data;
+
+    return true;
+}
+
+void MappedFile::Unmap()
+{
+    if (m_data != nullptr)
+    {
+        munmap(m_data, m_size);
+        m_data = nullptr;
+    }
+}
+
+void MappedFile::AdviseSequential()
+{
+    if (m_data != nullptr)
+    {
+        madvise(m_data, m_size, MADV_SEQUENTIAL);
+    }
+}
+
+void MappedFile::AdviseWillNeed()
+{
+    if (m_data != nullptr)
+    {
+        madvise(m_data, m_size, MADV_WILLNEED);
+    }
+}
+
+void MappedFile::AdvisePageOut()
+{
+    if (m_data != nullptr)
+    {
+#ifdef MADV_PAGEOUT
+        madvise(m_data, m_size, MADV_PAGEOUT);
+#else
+        // 共享文件映射中的数据会保留在文件里，可以直接丢弃
+        madvise(m_data, m_size, MADV_DONTNEED);
+#endif
+    }
+}
+
+#endif
@@ -0,0 +1,28 @@
+#include "ECS/Prefab.h"
+
+const void* Prefab::GetCompData(const CompRecord& record) const
+{
+    if (record.holder != nullptr)
+    {
+        return record.holder.get();
+    }
+
+    return m_blob.data() + record.offset;
+}
+
+bool Prefab::SameCompTypes(const Prefab& other) const
+{
+    if (m_records.size() != other.m_records.size())
+    {
+        return false;
+    }
+    for (std::size_t i = 0; i < m_records.size(); i++)
+    {
+        if (m_records[ i ].type_name != other.m_records[ i ].type_name)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -1,11 +1,150 @@
+#include <algorithm>
+#include <cassert>
 #include "ECS/SystemMngr.h"
 
+void SystemMngr::SetFixedTimeStep(float step, unsigned int max_steps)
+{
+    assert(step > 0.0f && "Fixed time step must be positive!");
+
+    m_fixed_step = step;
+    m_max_fixed_steps = max_steps;
+}
+
 void SystemMngr::Update(float dt)
 {
-    // 调用所有系统的更新函数
-    for (auto pair : m_type_to_system)
+    UpdatePhase(SystemPhase::PRE_UPDATE, dt);
+
+    // 以固定步长消耗累积的时间
+    m_fixed_accumulator += dt;
+    unsigned int steps = 0;
+    while (m_fixed_accumulator >= m_fixed_step && steps < m_max_fixed_steps)
     {
-        pair.second->OnUpdate(dt);
+        UpdatePhase(SystemPhase::FIXED_UPDATE, m_fixed_step);
+        m_fixed_accumulator -= m_fixed_step;
+        steps += 1;
+    }
+    // 达到单帧步数上限时丢弃剩余时间
+    if (steps == m_max_fixed_steps && m_fixed_accumulator >= m_fixed_step)
+    {
+        m_fixed_accumulator = 0.0f;
+    }
+
+    UpdatePhase(SystemPhase::UPDATE, dt);
+    UpdatePhase(SystemPhase::POST_UPDATE, dt);
+}
+
+void SystemMngr::UpdatePhase(SystemPhase phase, float dt)
+{
+    for (auto& pair : m_type_to_system)
+    {
+        ScheduleState& state = m_type_to_schedule[ pair.first ];
+        if (state.schedule.phase == phase)
+        {
+            RunSystem(state, *pair.second, dt);
+        }
+    }
+}
+
+void SystemMngr::RunSystem(ScheduleState& state, System& system, float dt)
+{
+    state.elapsed += dt;
+    state.tick += 1;
+    // 未达到执行间隔时只累积时间
+    if (state.tick < state.schedule.rate_divider)
+    {
+        return ;
+    }
+    float run_dt = state.elapsed;
+    state.tick = 0;
+    state.elapsed = 0.0f;
+
+    if (state.schedule.time_slices > 1)
+    {
+        for (float& group_elapsed : state.group_elapsed)
+        {
+            group_elapsed += run_dt;
+        }
+        // 本组经过的时间从上一次轮到本组时开始计算
+        system.slice_dt = state.group_elapsed[ state.slice_group ];
+        state.group_elapsed[ state.slice_group ] = 0.0f;
+        system.slice = state.groups[ state.slice_group ];
+        state.slice_group = (state.slice_group + 1) % state.schedule.time_slices;
+    }
+
+    system.OnUpdate(run_dt);
+}
+
+void SystemMngr::JoinSlice(ScheduleState& state, Entity entity)
+{
+    if (state.schedule.time_slices <= 1)
+    {
+        return ;
+    }
+
+    auto smallest = std::min_element(state.groups.begin(), state.groups.end(),
+        [](const std::vector<Entity>& a, const std::vector<Entity>& b) { return a.size() < b.size(); });
+    unsigned int group = static_cast<unsigned int>(smallest - state.groups.begin());
+    state.entity_slots[ entity ] = {group, smallest->size()};
+    smallest->push_back(entity);
+}
+
+void SystemMngr::LeaveSlice(ScheduleState& state, Entity entity)
+{
+    if (state.schedule.time_slices <= 1)
+    {
+        return ;
+    }
+
+    auto iter = state.entity_slots.find(entity);
+    if (iter == state.entity_slots.end())
+    {
+        return ;
+    }
+    unsigned int group = iter->second.first;
+    RemoveFromGroup(state, group, iter->second.second);
+    state.entity_slots.erase(iter);
+
+    // 保持各组实体数量至多相差 1
+    auto largest = std::max_element(state.groups.begin(), state.groups.end(),
+        [](const std::vector<Entity>& a, const std::vector<Entity>& b) { return a.size() < b.size(); });
+    std::vector<Entity>& members = state.groups[ group ];
+    if (largest->size() > members.size() + 1)
+    {
+        Entity moved = largest->back();
+        largest->pop_back();
+        state.entity_slots[ moved ] = {group, members.size()};
+        members.push_back(moved);
+    }
+}
+
+void SystemMngr::ResetSlices(ScheduleState& state, const std::set<Entity>& entities)
+{
+    if (state.schedule.time_slices <= 1)
+    {
+        return ;
+    }
+
+    for (std::vector<Entity>& members : state.groups)
+    {
+        members.clear();
+    }
+    state.entity_slots.clear();
+    for (Entity entity : entities)
+    {
+        JoinSlice(state, entity);
+    }
+}
+
+void SystemMngr::RemoveFromGroup(ScheduleState& state, unsigned int group, std::size_t pos)
+{
+    std::vector<Entity>& members = state.groups[ group ];
+    Entity last = members.back();
+    members[ pos ] = last;
+    members.pop_back();
+    // 被移动的实体更新其在组内的位置
+    if (pos < members.size())
+    {
+        state.entity_slots[ last ].second = pos;
     }
 }
 
@@ -18,7 +157,10 @@ void SystemMngr::UpdateEntities(UpdateEntitiesType update_type, Entity entity, S
 
             for (auto pair : m_type_to_system)
             {
-                pair.second->entities.erase(entity);
+                if (pair.second->entities.erase(entity) > 0)
+                {
+                    LeaveSlice(m_type_to_schedule[ pair.first ], entity);
+                }
             }
 
             break;
@@ -31,14 +173,36 @@ void SystemMngr::UpdateEntities(UpdateEntitiesType update_type, Entity entity, S
                 Signature system_signature = m_type_to_signature[ type_name ];
                 if ((signature & system_signature) == system_signature)
                 {
-                    pair.second->entities.insert(entity);
+                    if (pair.second->entities.insert(entity).second)
+                    {
+                        JoinSlice(m_type_to_schedule[ type_name ], entity);
+                    }
                 }
-                else
+                else if (pair.second->entities.erase(entity) > 0)
                 {
-                    pair.second->entities.erase(entity);
+                    LeaveSlice(m_type_to_schedule[ type_name ], entity);
                 }
             }
 
             break;
     }
 }
+
+void SystemMngr::AddEntities(const std::vector<Entity>& entities, Signature signature)
+{
+    for (auto& pair : m_type_to_system)
+    {
+        Signature system_signature = m_type_to_signature[ pair.first ];
+        if ((signature & system_signature) == system_signature)
+        {
+            ScheduleState& state = m_type_to_schedule[ pair.first ];
+            for (Entity entity : entities)
+            {
+                if (pair.second->entities.insert(entity).second)
+                {
+                    JoinSlice(state, entity);
+                }
+            }
+        }
+    }
+}
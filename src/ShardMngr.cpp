@@ -0,0 +1,151 @@
+#include <cassert>
+#include "ShardMngr.h"
+
+ShardMngr::ShardMngr(std::size_t shard_num)
+    : m_migrate_requests(shard_num),
+      m_transfers(shard_num * shard_num),
+      m_frame_barrier(shard_num + 1),
+      m_phase_barrier(shard_num),
+      m_dt(0.0f),
+      m_running(true)
+{
+    assert(shard_num > 0 && "The number of shards must be positive!");
+
+    for (std::size_t i = 0; i < shard_num; i++)
+    {
+        m_shards.push_back(std::make_unique<World>());
+        m_inboxes.push_back(std::make_unique<EventMngr>());
+    }
+    for (std::size_t i = 0; i < shard_num; i++)
+    {
+        m_threads.emplace_back(&ShardMngr::RunShard, this, i);
+    }
+}
+
+ShardMngr::~ShardMngr()
+{
+    // 放行等待在帧开始处的分片线程，使其退出
+    m_running = false;
+    m_frame_barrier.Wait();
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+std::size_t ShardMngr::GetShardNum() const
+{
+    return m_shards.size();
+}
+
+World& ShardMngr::GetShard(std::size_t shard)
+{
+    assert(shard < m_shards.size() && "The shard does not exist!");
+
+    return *m_shards[ shard ];
+}
+
+void ShardMngr::Migrate(std::size_t from, Entity entity, std::size_t to)
+{
+    assert(from < m_shards.size() && to < m_shards.size() &&
+        "The shard does not exist!");
+
+    if (from != to)
+    {
+        m_migrate_requests[ from ].push_back({entity, to});
+    }
+}
+
+void ShardMngr::SetMigrateCallback(
+    const std::function<void(std::size_t, Entity, std::size_t, Entity)>& on_migrate)
+{
+    m_on_migrate = on_migrate;
+}
+
+void ShardMngr::Update(float dt)
+{
+    m_dt = dt;
+    // 帧开始
+    m_frame_barrier.Wait();
+    // 等待所有分片完成本帧
+    m_frame_barrier.Wait();
+}
+
+void ShardMngr::RunShard(std::size_t shard)
+{
+    while (true)
+    {
+        m_frame_barrier.Wait();
+        if (!m_running)
+        {
+            return ;
+        }
+
+        m_shards[ shard ]->Update(m_dt);
+        // 所有分片更新结束后不再有消息发送
+        m_phase_barrier.Wait();
+
+        m_inboxes[ shard ]->Swap();
+        ExportMigrations(shard);
+        // 所有迁出的实体都已进入迁移队列
+        m_phase_barrier.Wait();
+
+        ImportMigrations(shard);
+        m_frame_barrier.Wait();
+    }
+}
+
+void ShardMngr::ExportMigrations(std::size_t shard)
+{
+    World& world = *m_shards[ shard ];
+    std::size_t shard_num = m_shards.size();
+    for (auto& request : m_migrate_requests[ shard ])
+    {
+        Entity entity = request.first;
+        // 同一实体被请求多次或已被销毁时只迁移一次
+        if (!world.IsAlive(entity))
+        {
+            continue;
+        }
+
+        std::size_t to = request.second;
+        m_transfers[ to * shard_num + shard ].push_back({entity, world.ExportEntity(entity)});
+        world.DestroyEntity(entity);
+    }
+    m_migrate_requests[ shard ].clear();
+}
+
+void ShardMngr::ImportMigrations(std::size_t shard)
+{
+    World& world = *m_shards[ shard ];
+    std::size_t shard_num = m_shards.size();
+    // 所有迁入的实体一起创建，组件类型相同的实体共用一次容器查找与系统更新
+    std::vector<const Prefab*> prefabs;
+    for (std::size_t from = 0; from < shard_num; from++)
+    {
+        for (const Transfer& transfer : m_transfers[ shard * shard_num + from ])
+        {
+            prefabs.push_back(&transfer.comps);
+        }
+    }
+    if (prefabs.empty())
+    {
+        return ;
+    }
+
+    std::vector<Entity> entities = world.InstantiateEach(prefabs);
+    std::size_t i = 0;
+    for (std::size_t from = 0; from < shard_num; from++)
+    {
+        std::vector<Transfer>& transfers = m_transfers[ shard * shard_num + from ];
+        for (const Transfer& transfer : transfers)
+        {
+            if (m_on_migrate)
+            {
+                m_on_migrate(from, transfer.entity, shard, entities[ i ]);
+            }
+            i += 1;
+        }
+        transfers.clear();
+    }
+}
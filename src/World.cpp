@@ -1,9 +1,12 @@
+#include <cassert>
 #include "World.h"
 
 World::World()
 {
     m_entity_mngr = std::make_unique<EntityMngr>();
     m_system_mngr = std::make_unique<SystemMngr>();
+    m_event_mngr = std::make_unique<EventMngr>();
+    m_hierarchy_mngr = std::make_unique<HierarchyMngr>();
 }
 
 Entity World::CreateEntity()
@@ -11,14 +14,132 @@ Entity World::CreateEntity()
     return m_entity_mngr->CreateEntity();
 }
 
+Entity World::ReserveEntity()
+{
+    return m_entity_mngr->ReserveEntity();
+}
+
+void World::FlushReservedEntities()
+{
+    // 新实体签名为空，不被任何系统订阅，不需要更新系统的实体集合
+    m_entity_mngr->FlushReservedEntities();
+}
+
+bool World::IsAlive(Entity entity) const
+{
+    return m_entity_mngr->IsAlive(entity);
+}
+
+std::vector<Entity> World::Instantiate(const Prefab& prefab, std::size_t n,
+    const std::function<void(Entity, std::size_t)>& on_instance)
+{
+    std::vector<Entity> entities = m_entity_mngr->Instantiate(prefab, n);
+    if (entities.empty())
+    {
+        return entities;
+    }
+
+    // 同一预制体创建的实体签名相同，在回调修改组件之前读取
+    m_system_mngr->AddEntities(entities, m_entity_mngr->GetSignature(entities.front()));
+    // 回调中增删组件时由 AtachComp 与 DeAtachComp 单独更新该实体所在的系统
+    if (on_instance)
+    {
+        for (std::size_t i = 0; i < entities.size(); i++)
+        {
+            on_instance(entities[ i ], i);
+        }
+    }
+
+    return entities;
+}
+
+std::vector<Entity> World::InstantiateEach(const std::vector<const Prefab*>& prefabs)
+{
+    std::vector<Entity> entities(prefabs.size(), INVALID_ENTITY);
+    std::vector<bool> created(prefabs.size(), false);
+    for (std::size_t i = 0; i < prefabs.size(); i++)
+    {
+        if (created[ i ])
+        {
+            continue;
+        }
+
+        // 收集之后所有组件类型与当前预制体相同的预制体
+        std::vector<const Prefab*> batch;
+        std::vector<std::size_t> positions;
+        for (std::size_t j = i; j < prefabs.size(); j++)
+        {
+            if (!created[ j ] && prefabs[ j ]->SameCompTypes(*prefabs[ i ]))
+            {
+                batch.push_back(prefabs[ j ]);
+                positions.push_back(j);
+                created[ j ] = true;
+            }
+        }
+
+        std::vector<Entity> batch_entities = m_entity_mngr->InstantiateEach(batch);
+        m_system_mngr->AddEntities(batch_entities, m_entity_mngr->GetSignature(batch_entities.front()));
+        for (std::size_t k = 0; k < positions.size(); k++)
+        {
+            entities[ positions[ k ] ] = batch_entities[ k ];
+        }
+    }
+
+    return entities;
+}
+
+Prefab World::ExportEntity(Entity entity)
+{
+    Prefab prefab;
+    m_entity_mngr->ExportEntity(entity, prefab);
+
+    return prefab;
+}
+
 void World::DestroyEntity(Entity entity)
 {
+    // 实体的子实体成为根实体
+    m_hierarchy_mngr->Remove(entity);
     m_entity_mngr->DestroyEntity(entity);
     // 更新系统的实体集合
     // 实体被销毁时不需要使用到第三个参数，传递空签名即可
     m_system_mngr->UpdateEntities(UpdateEntitiesType::ENTITY_DESTROYED, entity, Signature());
 }
 
+void World::DestroySubtree(Entity root)
+{
+    std::vector<Entity> subtree = m_hierarchy_mngr->GetSubtree(root);
+    // 从叶子开始销毁，每次移除都不需要再处理子实体
+    for (auto iter = subtree.rbegin(); iter != subtree.rend(); iter++)
+    {
+        DestroyEntity(*iter);
+    }
+}
+
+void World::SetParent(Entity child, Entity parent)
+{
+    assert(IsAlive(child) && (parent == INVALID_ENTITY || IsAlive(parent)) &&
+        "Entity does not exist");
+
+    m_hierarchy_mngr->SetParent(child, parent);
+}
+
+void World::SetParents(const std::vector<std::pair<Entity, Entity> >& child_parent_pairs)
+{
+    for (const auto& pair : child_parent_pairs)
+    {
+        assert(IsAlive(pair.first) && (pair.second == INVALID_ENTITY || IsAlive(pair.second)) &&
+            "Entity does not exist");
+    }
+
+    m_hierarchy_mngr->SetParents(child_parent_pairs);
+}
+
+Entity World::GetParent(Entity entity) const
+{
+    return m_hierarchy_mngr->GetParent(entity);
+}
+
 Signature World::GetEntitySignature(Entity entity)
 {
     return m_entity_mngr->GetSignature(entity);
@@ -29,7 +150,21 @@ std::set<EntityId> World::GetEntities(Signature signature)
     return m_entity_mngr->GetEntities(signature);
 }
 
+void World::SetFixedTimeStep(float step, unsigned int max_steps)
+{
+    m_system_mngr->SetFixedTimeStep(step, max_steps);
+}
+
+void World::TrimColdComps()
+{
+    m_entity_mngr->TrimColdComps();
+}
+
 void World::Update(float dt)
 {
     m_system_mngr->Update(dt);
+    // 交换事件缓冲，本帧发送的事件在下一帧被读取
+    m_event_mngr->Swap();
+    // 将本帧被修改的双缓冲组件发布到前台缓冲
+    m_entity_mngr->SwapCompBuffers();
 }